@@ -4,17 +4,69 @@
 #include <time.h>
 #include <string.h>
 #include <math.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#ifdef _WIN32
+// windows.h conflita com raylib.h (Rectangle, CloseWindow, DrawText...),
+// ento s as funes usadas so declaradas, como faz a prpria raylib
+__declspec(dllimport) void __stdcall Sleep(unsigned long milliseconds);
+__declspec(dllimport) unsigned long __stdcall GetActiveProcessorCount(unsigned short groupNumber);
+__declspec(dllimport) int __stdcall QueryPerformanceCounter(long long *count);
+__declspec(dllimport) int __stdcall QueryPerformanceFrequency(long long *frequency);
+#else
+#include <unistd.h>
+#endif
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
 // Definies de constantes
 #define SCREEN_WIDTH 800
 #define SCREEN_HEIGHT 800
-#define GRID_SIZE 15
+#ifndef GRID_SIZE
+#define GRID_SIZE 15        // Pode ser redefinido na compilao (ex: -DGRID_SIZE=41)
+#endif
 #define TILE_SIZE 40
+#ifndef MAX_ENEMIES
 #define MAX_ENEMIES 10
-#define MAX_BOMBS 5
+#endif
+#define MAX_PLAYERS 8
+#define MAX_HUMAN_PLAYERS 4
+#define MAX_BOMBS_PER_PLAYER 5
+#define MAX_BOMBS (MAX_PLAYERS * MAX_BOMBS_PER_PLAYER)
 #define MAX_LEVELS 5
+#define BOT_THINK_TICKS 10  // Bots decidem um movimento a cada 10 frames
+#define SIM_DT (1.0 / 60.0) // Durao de um tick da simulao
+#define MAX_SIM_STEPS 5     // Ticks mximos por frame ao recuperar atrasos
+#define INPUT_QUEUE_SIZE 64
+#define LATENCY_SAMPLES 256
+#define TELEMETRY_RING_SIZE 4096    // Potncia de 2
+#define POOL_MAX_THREADS 64
+
+// Ambiente vetorizado para treino (RL)
+#define OBS_PLANES 10
+#define OBS_SIZE (OBS_PLANES * GRID_SIZE * GRID_SIZE)  // Valores por ambiente
+#define ENV_MAX_STEPS 1000      // Decises por episdio antes de truncar
+
+// Renderizao por CPU de partidas gravadas
+#define FRAME_QUEUE_SIZE 16     // Frames aguardando render/codificao
+#define FRAME_MAX_THREADS 64
+
+// Varredura de parmetros de dificuldade
+#define SWEEP_MAX_TICKS (60 * 180)  // Partidas mais longas contam como tempo esgotado
+
+// Constantes do bot MCTS
+#define MCTS_MAX_THREADS 64
+#define MCTS_MAX_NODES 32768    // Ns da rvore por thread
+#define MCTS_HORIZON 12         // Decises simuladas por playout (12 * BOT_THINK_TICKS frames)
+#define MCTS_BUDGET 0.002       // Tempo por deciso em segundos
 #define MAX_EXPLOSIONS 100
 
+// Constantes da replicao de estado
+#define NET_CELLS (GRID_SIZE * GRID_SIZE)
+#define NET_HISTORY 64      // Ticks guardados como possveis baselines
+#define NET_MAX_PACKET (64 + NET_CELLS * 3 + MAX_ENEMIES * 8 + MAX_PLAYERS * 16)
+
 // Tipos de texturas
 typedef enum {
     TEX_EMPTY,
@@ -40,16 +92,74 @@ typedef enum {
     RANGE_POWERUP
 } TileType;
 
+// Tipo de IA usada pelos bots
+typedef enum {
+    BOT_HEURISTIC,
+    BOT_MCTS
+} BotType;
+
+// Teclas de um jogador
+typedef struct {
+    int up, down, left, right, bomb;
+} PlayerControls;
+
 // Estrutura do jogador
 typedef struct {
     float realX, realY; // Posio real para interpolao
     int x, y;           // Posio no grid
     int max_bombs;
     int bomb_range;
+    int bomb_count;     // Bombas ativas deste jogador
+    int score;
     bool alive;
+    bool is_bot;
+    BotType bot_type;
+    int bot_timer;
     int direction;      // 0: direita, 1: esquerda, 2: cima, 3: baixo
+    PlayerControls controls;
+    int death_cause;    // DeathCause da ltima morte
+    int killed_by;      // Dono da bomba que matou (-1 = nenhum)
 } Player;
 
+// Comandos de um jogador em um tick
+typedef struct {
+    int dx, dy;         // -1, 0 ou 1
+    bool bomb;
+} PlayerInput;
+
+// Tecla de jogo lida do teclado, com o instante em que foi lida
+typedef struct {
+    double time;
+    int player;
+    PlayerInput input;
+} InputEvent;
+
+// Fila de entrada entre o teclado e a simulao de passo fixo. Cada tick
+// consome no mximo um evento por jogador; o resto fica para os prximos.
+// Tambm mede a latncia entre a leitura da tecla e o primeiro frame
+// desenhado depois de o evento ser aplicado.
+typedef struct {
+    InputEvent events[INPUT_QUEUE_SIZE];
+    int count;
+    int dropped;                        // Eventos descartados com a fila cheia
+
+    double applied[INPUT_QUEUE_SIZE];   // Eventos aplicados esperando o prximo frame
+    int applied_count;
+
+    float samples[LATENCY_SAMPLES];     // ltimas latncias medidas (ms)
+    int sample_count;
+    int sample_next;
+    double latency_sum;
+    double latency_max;
+    long long latency_count;
+
+    int frame_keys[16];                 // Outras teclas pressionadas neste frame
+    int frame_key_count;
+
+    bool low_latency;
+    bool show_latency;
+} InputQueue;
+
 // Estrutura do inimigo
 typedef struct {
     float realX, realY; // Posio real para interpolao
@@ -63,6 +173,7 @@ typedef struct {
     int x, y;
     int timer;
     int range;
+    int owner;          // ndice do jogador que plantou (-1 = desconhecido)
     bool exploded;
 } Bomb;
 
@@ -72,9 +183,69 @@ typedef struct {
     int timer;
 } Explosion;
 
+// Eventos de jogo publicados na telemetria
+typedef enum {
+    EVENT_LEVEL_START,
+    EVENT_BOMB_PLANTED,
+    EVENT_ENEMY_KILLED,
+    EVENT_SCORE,
+    EVENT_POWERUP,
+    EVENT_PLAYER_DEATH,
+    EVENT_LEVEL_COMPLETE,
+    EVENT_GAME_OVER,
+    NUM_EVENT_TYPES
+} EventType;
+
+// Causas de morte de um jogador
+typedef enum {
+    DEATH_EXPLOSION,
+    DEATH_ENEMY,
+    NUM_DEATH_CAUSES
+} DeathCause;
+
+// Um evento de telemetria. value/other dependem do tipo:
+//   ENEMY_KILLED: pontos / -        SCORE: pontos ganhos / score total
+//   POWERUP: TileType coletado / -  PLAYER_DEATH: DeathCause / dono da bomba
+//   LEVEL_*, GAME_OVER: fase / -
+typedef struct {
+    double time;          // GetMonotonicTime() quando o evento aconteceu
+    unsigned int tick;
+    int value;
+    int other;
+    short x, y;
+    unsigned char type;
+    signed char player;   // -1 = nenhum
+} TelemetryEvent;
+
+typedef struct Telemetry Telemetry;
+
+// ndice espacial: quem ocupa cada clula, para evitar varrer todas as
+// listas nas colises. Inimigos e jogadores formam listas encadeadas por clula.
+typedef struct {
+    unsigned char bomb[GRID_SIZE][GRID_SIZE];   // ndice da bomba + 1 (0 = nenhuma)
+    short enemy[GRID_SIZE][GRID_SIZE];          // Primeiro inimigo na clula (-1 = nenhum)
+    short enemyNext[MAX_ENEMIES];
+    short player[GRID_SIZE][GRID_SIZE];         // Primeiro jogador na clula (-1 = nenhum)
+    short playerNext[MAX_PLAYERS];
+} SpatialIndex;
+
+// Parmetros de dificuldade, ajustveis em tempo de execuo
+// (valores padro em DEFAULT_DIFFICULTY, limites em DifficultyValidate)
+typedef struct {
+    bool configured;        // false = usar DEFAULT_DIFFICULTY
+    int walls_base;         // Paredes destrutveis: base + fase * walls_per_level
+    int walls_per_level;
+    int enemies_base;       // Inimigos: base + fase * enemies_per_level
+    int enemies_per_level;
+    int bomb_fuse;          // Ticks at a bomba explodir
+    int fire_ticks;         // Ticks que o fogo continua queimando
+    int enemy_move_ticks;   // Ticks entre dois passos de um inimigo
+} DifficultyConfig;
+
 // Estrutura do jogo
 typedef struct {
-    Player player;
+    Player players[MAX_PLAYERS];
+    int player_count;
     Enemy enemies[MAX_ENEMIES];
     int enemy_count;
     Bomb bombs[MAX_BOMBS];
@@ -84,12 +255,252 @@ typedef struct {
     TileType grid[GRID_SIZE][GRID_SIZE];
     TileType hiddenGrid[GRID_SIZE][GRID_SIZE];
     int level;
-    int score;
+    int score;          // Soma dos pontos de todos os jogadores
+    unsigned int rng;   // Estado do gerador aleatrio da simulao (0 = ainda no semeado)
+    unsigned int tick;  // Ticks simulados desde o ResetGame
+    DifficultyConfig difficulty;
+    Telemetry *telemetry; // Destino dos eventos (NULL = desligado, ex: cpias do MCTS)
     bool game_over;
     bool level_complete;
+    SpatialIndex index;
     Texture2D textures[NUM_TEXTURES]; // Texturas do jogo
 } GameState;
 
+// Snapshot compacto do estado visvel (o que o DrawGame precisa)
+typedef struct {
+    unsigned int tick;
+    unsigned char grid[NET_CELLS];
+    unsigned char fire[NET_CELLS];   // 1 se h exploso na clula
+    unsigned char bombs[NET_CELLS];  // 1 se h bomba armada na clula
+    int player_count;
+    int player_pos[MAX_PLAYERS];     // y * GRID_SIZE + x
+    unsigned char player_flags[MAX_PLAYERS]; // bit 0: vivo, bits 1-2: direo, bit 3: bot
+    unsigned char max_bombs[MAX_PLAYERS];
+    unsigned char bomb_range[MAX_PLAYERS];
+    unsigned char bomb_count[MAX_PLAYERS];   // Bombas ativas de cada jogador
+    int player_score[MAX_PLAYERS];
+    int enemy_count;
+    int enemy_pos[MAX_ENEMIES];      // -1 se o inimigo est morto
+    int level;
+    int score;
+    unsigned char state_flags;       // bit 0: game_over, bit 1: level_complete
+} NetSnapshot;
+
+// Lado do servidor: histrico de snapshots indexado por tick
+typedef struct {
+    NetSnapshot history[NET_HISTORY];
+    unsigned int tick;
+} NetServer;
+
+// Estado de cada cliente/espectador no servidor
+typedef struct {
+    unsigned int acked_tick; // ltimo tick confirmado (0 = nenhum)
+} NetPeer;
+
+// Lado do cliente: snapshots recebidos, usados como baseline dos prximos pacotes
+typedef struct {
+    NetSnapshot history[NET_HISTORY];
+    unsigned int last_tick;
+} NetDecoder;
+
+// Aes do bot MCTS (uma por deciso)
+typedef enum {
+    ACTION_STAY,
+    ACTION_UP,
+    ACTION_DOWN,
+    ACTION_LEFT,
+    ACTION_RIGHT,
+    ACTION_BOMB,
+    NUM_ACTIONS
+} BotAction;
+
+// Pool de threads genrico: divide um intervalo [0, count) em blocos que
+// as threads (incluindo a que chamou) vo pegando at acabar
+typedef void (*ParallelFn)(void *context, int begin, int end);
+
+typedef struct {
+    pthread_t threads[POOL_MAX_THREADS];
+    int thread_count;           // Threads auxiliares
+    pthread_mutex_t lock;
+    pthread_cond_t start;
+    pthread_cond_t done;
+    int generation;
+    int pending;
+    bool quit;
+
+    // Trabalho em andamento
+    ParallelFn fn;
+    void *context;
+    int count;
+    int chunk;
+    atomic_int next;
+} WorkerPool;
+
+// N da rvore de busca. A rvore  "open loop": cada n representa uma
+// sequncia de aes e o estado  re-simulado a partir da raiz em cada playout,
+// j que inimigos e outros bots se movem de forma aleatria.
+typedef struct {
+    int children[NUM_ACTIONS]; // -1 = no expandido
+    int visits;
+    float value;
+} MctsNode;
+
+typedef struct MctsSearch MctsSearch;
+
+typedef struct {
+    MctsSearch *search;
+    MctsNode *nodes;
+    int node_count;
+    unsigned int rng;
+    long long playouts;
+    long long frames;          // Frames simulados na ltima busca
+    int visits[NUM_ACTIONS];
+    float value[NUM_ACTIONS];
+} MctsWorker;
+
+// Pool de threads da busca: cada thread monta sua prpria rvore a partir do
+// mesmo estado raiz e as visitas da raiz so somadas no final
+struct MctsSearch {
+    MctsWorker workers[MCTS_MAX_THREADS];
+    int thread_count;       // rvores por deciso (uma por thread do pool)
+    WorkerPool pool;
+
+    // Deciso em andamento
+    GameState root;
+    int player;
+    double deadline;
+
+    // Estatsticas
+    long long last_playouts;
+    long long total_playouts;
+    long long total_frames;
+    double total_seconds;
+    int decisions;
+};
+
+// Telemetria: a simulao publica eventos numa fila circular lock-free de
+// um produtor e um consumidor. Uma thread em segundo plano grava o log e o
+// arquivo de mtricas; a simulao nunca espera nem aloca memria.
+struct Telemetry {
+    TelemetryEvent events[TELEMETRY_RING_SIZE];
+    _Alignas(64) atomic_uint head;      // Prximo evento a ler (consumidor)
+    _Alignas(64) atomic_uint tail;      // Prximo evento a escrever (produtor)
+    atomic_uint dropped;                // Eventos perdidos com a fila cheia
+    _Alignas(64) atomic_bool running;
+
+    pthread_t thread;
+    FILE *log;
+    bool binary;
+    char metrics_path[256];
+    double start_time;
+
+    // Agregados para as mtricas (s a thread de escrita usa)
+    long long counts[NUM_EVENT_TYPES];
+    long long deaths[NUM_DEATH_CAUSES];
+    long long score_total;
+    long long player_score[MAX_PLAYERS];
+    long long written;
+    int level;
+    unsigned int last_tick;
+};
+
+// Planos de observao, em ordem, cada um com GRID_SIZE x GRID_SIZE valores
+typedef enum {
+    OBS_INDESTRUCTIBLE,
+    OBS_DESTRUCTIBLE,
+    OBS_EXIT,
+    OBS_BOMB_POWERUP,
+    OBS_RANGE_POWERUP,
+    OBS_SELF,               // O agente (jogador 0)
+    OBS_OTHER_PLAYERS,
+    OBS_ENEMIES,
+    OBS_BOMBS,              // Frao do pavio restante
+    OBS_FIRE
+} ObsPlane;
+
+// N partidas independentes controladas em lote. O agente  o jogador 0 e
+// cada ao (BotAction) vale por BOT_THINK_TICKS frames. Episdios que
+// terminam so reiniciados na hora com um mapa novo.
+typedef struct {
+    GameState *games;
+    int count;
+    int level;              // Fase usada ao gerar cada episdio
+    int bots;               // Bots simples alm do agente
+    int max_steps;
+    WorkerPool *pool;       // Opcional
+
+    // Por ambiente
+    int *steps;
+    float *returns;
+    int *episodes;
+    int *wins;
+    double *return_sum;
+
+    // Argumentos da chamada em andamento (lidos pelas threads)
+    const int *actions;
+    float *rewards;
+    unsigned char *dones;
+    float *obs_f32;
+    unsigned char *obs_u8;
+} VecEnv;
+
+// Interface de desenho usada por DrawGame e DrawHud. O backend raylib
+// desenha na janela; o de CPU compe os sprites num framebuffer em memria.
+typedef struct {
+    void *data;
+    void (*sprite)(void *data, TextureType texture, Vector2 position, Color tint);
+    void (*rect)(void *data, int x, int y, int width, int height, Color color);
+    void (*text)(void *data, const char *text, int x, int y, int size, Color color);
+} Renderer;
+
+// Sprite decodificado em RGBA8 para o backend de CPU
+typedef struct {
+    unsigned char *pixels;
+    int width;
+    int height;
+    bool opaque;            // Sem transparncia: linhas so copiadas direto
+} CpuSprite;
+
+// Destino do backend de CPU (RGBA8, linha por linha)
+typedef struct {
+    const CpuSprite *sprites;   // NUM_TEXTURES, somente leitura
+    unsigned char *pixels;
+    int width;
+    int height;
+} CpuTarget;
+
+// Frame enfileirado: cpia do estado, desenhada e codificada por uma thread
+typedef struct {
+    GameState state;
+    long long index;
+    int status;             // FRAME_FREE, FRAME_QUEUED ou FRAME_WORKING
+} FrameJob;
+
+// Desenha e grava sequncias de frames em threads: PNGs numerados ou um
+// arquivo de vdeo bruto RGBA (frames em ordem, um aps o outro)
+typedef struct {
+    FrameJob jobs[FRAME_QUEUE_SIZE];
+    CpuSprite sprites[NUM_TEXTURES];
+    pthread_t threads[FRAME_MAX_THREADS];
+    int thread_count;
+    pthread_mutex_t lock;
+    pthread_cond_t work;
+    pthread_cond_t space;
+    pthread_cond_t written;
+    long long submitted;
+    long long next_write;   // Prximo frame a entrar no vdeo bruto
+    bool quit;
+
+    FILE *raw;              // Vdeo bruto, ou NULL
+    char png_prefix[256];   // Prefixo dos PNGs, ou vazio
+    bool failed;
+
+    // Estatsticas
+    long long frames;
+    double render_seconds;
+    double encode_seconds;
+} FrameEncoder;
+
 // Estrutura do menu
 typedef enum {
     MAIN_MENU,
@@ -101,18 +512,157 @@ typedef enum {
 
 // Prottipos de funes
 void InitGame(GameState *game, int level);
+unsigned int GameRandom(GameState *game);
 void GenerateLevel(GameState *game);
-void DrawGame(GameState *game);
-void UpdateGame(GameState *game);
-void PlantBomb(GameState *game);
+void DifficultyValidate(DifficultyConfig *config);
+void DrawGame(const Renderer *renderer, const GameState *game);
+void DrawHud(const Renderer *renderer, const GameState *game);
+Renderer RaylibRenderer(Texture2D *textures);
+Renderer CpuRenderer(CpuTarget *target);
+void CpuLoadSprites(CpuSprite *sprites);
+void CpuUnloadSprites(CpuSprite *sprites);
+void CpuClear(CpuTarget *target, Color color);
+bool FrameEncoderStart(FrameEncoder *encoder, const char *output, int threads);
+void FrameEncoderSubmit(FrameEncoder *encoder, const GameState *game);
+void FrameEncoderStop(FrameEncoder *encoder);
+void RunReplayRender(const char *output, int players, int maxTicks, int threads);
+void RunDifficultySweep(int seeds, int level, int threads);
+void UpdateGame(GameState *game, MctsSearch *mcts, InputQueue *queue);
+void StepGame(GameState *game, const PlayerInput *inputs, float dt);
+void InputQueueInit(InputQueue *queue);
+void InputQueuePoll(InputQueue *queue, const GameState *game, double time);
+bool InputQueuePop(InputQueue *queue, int player, PlayerInput *input);
+bool InputQueueKeyPressed(const InputQueue *queue, int key);
+void InputQueueFramePresented(InputQueue *queue, double time);
+void InputQueueResetLatency(InputQueue *queue);
+float InputQueueLatencyPercentile(const InputQueue *queue, float percentile);
+void BotInput(GameState *game, int index, PlayerInput *input);
+void ConfigurePlayers(GameState *game, int humans, int bots, BotType botType);
+void GetSpawnPoint(int index, int *x, int *y);
+void PlantBomb(GameState *game, int owner);
 void ExplodeBomb(GameState *game, Bomb *bomb);
-void MoveEnemies(GameState *game);
+void MoveEnemies(GameState *game, float dt);
+bool IsWalkable(const GameState *game, int x, int y);
+void RebuildSpatialIndex(GameState *game);
+void RunBotMatch(int players, int maxTicks, Telemetry *telemetry);
 void LoadCustomMap(GameState *game, const char *filename);
 void SaveGame(GameState *game);
 bool LoadGame(GameState *game);
 void ResetGame(GameState *game);
+void NetCaptureSnapshot(const GameState *game, NetSnapshot *snap);
+void NetApplySnapshot(const NetSnapshot *snap, GameState *game);
+void NetServerInit(NetServer *server);
+void NetServerCapture(NetServer *server, const GameState *game);
+int NetEncodeDelta(const NetServer *server, const NetPeer *peer, unsigned char *buffer, int capacity);
+void NetPeerAck(NetPeer *peer, unsigned int tick);
+void NetDecoderInit(NetDecoder *decoder);
+bool NetDecodeDelta(NetDecoder *decoder, const unsigned char *buffer, int length, GameState *game, unsigned int *tick);
+void SmoothReplicatedState(GameState *game, float dt);
+double GetMonotonicTime(void);
+void MctsInit(MctsSearch *search, int threads);
+void MctsShutdown(MctsSearch *search);
+void MctsChooseInput(MctsSearch *search, const GameState *game, int player, double budget, PlayerInput *input);
+void RunMctsBenchmark(double budgetMs, int threads, int maxTicks);
+void RunNetBenchmark(int ticks);
+int ResolveThreadCount(int threads, int maxThreads);
+void WorkerPoolInit(WorkerPool *pool, int threads);
+void WorkerPoolShutdown(WorkerPool *pool);
+void WorkerPoolFor(WorkerPool *pool, int count, int chunk, ParallelFn fn, void *context);
+VecEnv *VecEnvCreate(int count, unsigned int seed, WorkerPool *pool);
+void VecEnvDestroy(VecEnv *env);
+void VecEnvReset(VecEnv *env, float *obsF32, unsigned char *obsU8);
+void VecEnvStep(VecEnv *env, const int *actions, float *rewards, unsigned char *dones, float *obsF32, unsigned char *obsU8);
+void VecEnvObserve(VecEnv *env, float *obsF32, unsigned char *obsU8);
+void RunEnvBenchmark(int threads);
+bool TelemetryStart(Telemetry *telemetry, const char *logPath, bool binary, const char *metricsPath);
+void TelemetryStop(Telemetry *telemetry);
+void TelemetryPublish(Telemetry *telemetry, const TelemetryEvent *event);
+
+// Arquivo de cada textura, na ordem de TextureType
+static const char *TEXTURE_FILES[NUM_TEXTURES] = {
+    "assets/empty.png",
+    "assets/indestructible.png",
+    "assets/destructible.png",
+    "assets/exit.png",
+    "assets/bomb_powerup.png",
+    "assets/range_powerup.png",
+    "assets/player.png",
+    "assets/enemy.png",
+    "assets/bomb.png",
+    "assets/explosion.png"
+};
+
+// Com -DBOMBERMAN_NO_MAIN o arquivo vira biblioteca (VecEnv, bots, replicao)
+// sem main, para ser ligado em outro programa
+#ifndef BOMBERMAN_NO_MAIN
+int main(int argc, char *argv[]) {
+    // Telemetria (--telemetry ou --telemetry=bin, em qualquer posio)
+    static Telemetry telemetry;
+    Telemetry *activeTelemetry = NULL;
+    bool telemetryRequested = false;
+    bool telemetryBinary = false;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--telemetry") == 0 || strcmp(argv[i], "--telemetry=json") == 0 ||
+            strcmp(argv[i], "--telemetry=bin") == 0) {
+            telemetryRequested = true;
+            telemetryBinary = strcmp(argv[i], "--telemetry=bin") == 0;
+            // Remove a opo para no atrapalhar os outros argumentos
+            for (int j = i; j < argc - 1; j++) {
+                argv[j] = argv[j + 1];
+            }
+            argc--;
+            i--;
+        }
+    }
+
+    // S o jogo e --bot-match geram eventos de jogo
+    if (telemetryRequested && argc > 1) {
+        static const char *const NO_TELEMETRY_MODES[] = {
+            "--bench-net", "--bench-mcts", "--render", "--sweep", "--bench-env"
+        };
+        for (int i = 0; i < (int)(sizeof(NO_TELEMETRY_MODES) / sizeof(NO_TELEMETRY_MODES[0])); i++) {
+            if (strcmp(argv[1], NO_TELEMETRY_MODES[i]) == 0) {
+                printf("--telemetry so funciona com o jogo e com --bot-match\n");
+                return 1;
+            }
+        }
+    }
+    if (telemetryRequested &&
+        TelemetryStart(&telemetry, telemetryBinary ? "telemetry.bin" : "telemetry.jsonl", telemetryBinary, "metrics.prom")) {
+        activeTelemetry = &telemetry;
+    }
+
+    // Modos sem janela
+    if (argc > 1 && strcmp(argv[1], "--bench-net") == 0) {
+        RunNetBenchmark(argc > 2 ? atoi(argv[2]) : 20000);
+        return 0;
+    }
+    if (argc > 1 && strcmp(argv[1], "--bench-mcts") == 0) {
+        RunMctsBenchmark(argc > 2 ? atof(argv[2]) : MCTS_BUDGET * 1000.0,
+                         argc > 3 ? atoi(argv[3]) : 0,
+                         argc > 4 ? atoi(argv[4]) : 60 * 60 * 3);
+        return 0;
+    }
+    if (argc > 2 && strcmp(argv[1], "--render") == 0) {
+        RunReplayRender(argv[2], argc > 3 ? atoi(argv[3]) : 4, argc > 4 ? atoi(argv[4]) : 3600,
+                        argc > 5 ? atoi(argv[5]) : 0);
+        return 0;
+    }
+    if (argc > 1 && strcmp(argv[1], "--sweep") == 0) {
+        RunDifficultySweep(argc > 2 ? atoi(argv[2]) : 200, argc > 3 ? atoi(argv[3]) : 1,
+                           argc > 4 ? atoi(argv[4]) : 0);
+        return 0;
+    }
+    if (argc > 1 && strcmp(argv[1], "--bench-env") == 0) {
+        RunEnvBenchmark(argc > 2 ? atoi(argv[2]) : 0);
+        return 0;
+    }
+    if (argc > 1 && strcmp(argv[1], "--bot-match") == 0) {
+        RunBotMatch(argc > 2 ? atoi(argv[2]) : 4, argc > 3 ? atoi(argv[3]) : 60 * 60 * 5, activeTelemetry);
+        if (activeTelemetry) TelemetryStop(activeTelemetry);
+        return 0;
+    }
 
-int main(void) {
     // Inicializao da janela
     InitWindow(SCREEN_WIDTH, SCREEN_HEIGHT, "Mini Bomberman");
     SetTargetFPS(60);
@@ -120,33 +670,72 @@ int main(void) {
     // Inicializao de variveis
     GameState game;
     memset(&game, 0, sizeof(GameState)); // Garantir inicializao
+    game.telemetry = activeTelemetry;
 
     // Carregar texturas
-    game.textures[TEX_EMPTY] = LoadTexture("assets/empty.png");
-    game.textures[TEX_INDESTRUCTIBLE] = LoadTexture("assets/indestructible.png");
-    game.textures[TEX_DESTRUCTIBLE] = LoadTexture("assets/destructible.png");
-    game.textures[TEX_EXIT] = LoadTexture("assets/exit.png");
-    game.textures[TEX_BOMB_POWERUP] = LoadTexture("assets/bomb_powerup.png");
-    game.textures[TEX_RANGE_POWERUP] = LoadTexture("assets/range_powerup.png");
-    game.textures[TEX_PLAYER] = LoadTexture("assets/player.png");
-    game.textures[TEX_ENEMY] = LoadTexture("assets/enemy.png");
-    game.textures[TEX_BOMB] = LoadTexture("assets/bomb.png");
-    game.textures[TEX_EXPLOSION] = LoadTexture("assets/explosion.png");
+    for (int i = 0; i < NUM_TEXTURES; i++) {
+        game.textures[i] = LoadTexture(TEXTURE_FILES[i]);
+    }
+    Renderer screen = RaylibRenderer(game.textures);
 
     GameScreen currentScreen = MAIN_MENU;
     bool saveFileExists = false;
     char mapFilename[256] = {0};
+    int humanPlayers = 1;
+    int botPlayers = 0;
+    BotType botType = BOT_HEURISTIC;
+
+    // Threads do bot MCTS (ficam paradas at alguma deciso ser pedida)
+    static MctsSearch mcts;
+    MctsInit(&mcts, 0);
+
+    // Fila de entrada e relgio da simulao de passo fixo
+    InputQueue input;
+    InputQueueInit(&input);
+    double accumulator = 0.0;
+    double nextTickTime = GetTime();
+    double lastPollTime = GetTime();
 
     // Verifica se existe arquivo de save
     saveFileExists = LoadGame(&game);
 
     // Loop principal do jogo
     while (!WindowShouldClose()) {
+        bool simulating = (currentScreen == PLAYING && !game.game_over && !game.level_complete);
+
+        // As teclas foram lidas no fim do EndDrawing anterior
+        InputQueuePoll(&input, &game, lastPollTime);
+
+        // Modo de baixa latncia: o ritmo dos frames  controlado aqui em vez
+        // do EndDrawing. A espera acontece antes de ler o teclado, ento a
+        // entrada  lida, simulada e desenhada logo em seguida.
+        if (input.low_latency) {
+            double remaining = nextTickTime - GetTime();
+            if (remaining > 0.0) {
+                WaitTime(remaining);
+            }
+            nextTickTime += SIM_DT;
+            if (nextTickTime < GetTime()) {
+                nextTickTime = GetTime();
+            }
+
+            if (simulating) {
+                PollInputEvents();
+                InputQueuePoll(&input, &game, GetTime());
+            }
+        }
+
+        // Fora do jogo as teclas de movimento so descartadas
+        if (!simulating) {
+            input.count = 0;
+        }
+
         // Atualizao do jogo
         switch (currentScreen) {
             case MAIN_MENU:
                 if (IsKeyPressed(KEY_ONE)) {
                     ResetGame(&game);
+                    ConfigurePlayers(&game, humanPlayers, botPlayers, botType);
                     InitGame(&game, 1);
                     currentScreen = PLAYING;
                 }
@@ -159,9 +748,24 @@ int main(void) {
                     currentScreen = LOAD_MAP;
                 }
                 else if (IsKeyPressed(KEY_FOUR)) {
+                    MctsShutdown(&mcts);
+                    if (activeTelemetry) TelemetryStop(activeTelemetry);
                     CloseWindow();
                     return 0;
                 }
+                else if (IsKeyPressed(KEY_FIVE)) {
+                    // 0 jogadores humanos = autoplay com bots
+                    humanPlayers = (humanPlayers + 1) % (MAX_HUMAN_PLAYERS + 1);
+                    if (humanPlayers + botPlayers > MAX_PLAYERS) botPlayers = MAX_PLAYERS - humanPlayers;
+                    if (humanPlayers == 0 && botPlayers == 0) botPlayers = 1;
+                }
+                else if (IsKeyPressed(KEY_SIX)) {
+                    botPlayers = (botPlayers + 1) % (MAX_PLAYERS - humanPlayers + 1);
+                    if (humanPlayers == 0 && botPlayers == 0) botPlayers = 1;
+                }
+                else if (IsKeyPressed(KEY_SEVEN)) {
+                    botType = (botType == BOT_MCTS) ? BOT_HEURISTIC : BOT_MCTS;
+                }
                 break;
 
             case LOAD_MAP:
@@ -185,12 +789,39 @@ int main(void) {
                 break;
 
             case PLAYING:
-                if (!game.game_over && !game.level_complete) {
-                    UpdateGame(&game);
+                if (InputQueueKeyPressed(&input, KEY_F1)) {
+                    input.show_latency = !input.show_latency;
+                }
+                if (InputQueueKeyPressed(&input, KEY_F2)) {
+                    input.low_latency = !input.low_latency;
+                    SetTargetFPS(input.low_latency ? 0 : 60);
+                    InputQueueResetLatency(&input);
+                    accumulator = 0.0;
+                    nextTickTime = GetTime();
+                }
+
+                if (simulating && input.low_latency) {
+                    // Um tick por frame, logo depois de ler a entrada
+                    UpdateGame(&game, &mcts, &input);
+                }
+                else if (simulating) {
+                    // Passo fixo: quantos ticks couberem no tempo do frame
+                    accumulator += GetFrameTime();
+                    int steps = 0;
+                    while (accumulator >= SIM_DT && steps < MAX_SIM_STEPS &&
+                           !game.game_over && !game.level_complete) {
+                        UpdateGame(&game, &mcts, &input);
+                        accumulator -= SIM_DT;
+                        steps++;
+                    }
+                    if (steps == MAX_SIM_STEPS) {
+                        accumulator = 0.0; // No tentar recuperar atrasos grandes
+                    }
                 }
                 else if (game.game_over) {
                     if (IsKeyPressed(KEY_ENTER)) {
                         ResetGame(&game);
+                        ConfigurePlayers(&game, humanPlayers, botPlayers, botType);
                         InitGame(&game, 1);
                         currentScreen = PLAYING;
                     }
@@ -211,6 +842,7 @@ int main(void) {
             case GAME_OVER:
                 if (IsKeyPressed(KEY_ENTER)) {
                     ResetGame(&game);
+                    ConfigurePlayers(&game, humanPlayers, botPlayers, botType);
                     InitGame(&game, 1);
                     currentScreen = PLAYING;
                 }
@@ -246,6 +878,9 @@ int main(void) {
 
                     DrawText("3. Carregar Mapa", SCREEN_WIDTH/2 - 50, 260, 20, BLACK);
                     DrawText("4. Sair", SCREEN_WIDTH/2 - 50, 290, 20, BLACK);
+                    DrawText(TextFormat("5. Jogadores: %d", humanPlayers), SCREEN_WIDTH/2 - 50, 340, 20, DARKGRAY);
+                    DrawText(TextFormat("6. Bots: %d", botPlayers), SCREEN_WIDTH/2 - 50, 370, 20, DARKGRAY);
+                    DrawText(TextFormat("7. IA dos bots: %s", botType == BOT_MCTS ? "MCTS" : "simples"), SCREEN_WIDTH/2 - 50, 400, 20, DARKGRAY);
                     break;
 
                 case LOAD_MAP:
@@ -255,13 +890,23 @@ int main(void) {
                     break;
 
                 case PLAYING:
-                    DrawGame(&game);
+                    DrawGame(&screen, &game);
+                    DrawHud(&screen, &game);
+
+                    if (mcts.total_seconds > 0.0) {
+                        DrawText(TextFormat("MCTS: %.0f playouts/s", mcts.total_playouts / mcts.total_seconds),
+                                 SCREEN_WIDTH - 250, 10, 20, DARKGRAY);
+                    }
 
-                    // Desenhar informaes da UI
-                    DrawText(TextFormat("Fase: %d", game.level), 10, 10, 20, BLACK);
-                    DrawText(TextFormat("Score: %d", game.score), 10, 40, 20, BLACK);
-                    DrawText(TextFormat("Bombas: %d/%d", game.player.max_bombs - game.bomb_count, game.player.max_bombs), 10, 70, 20, BLACK);
-                    DrawText(TextFormat("Alcance: %d", game.player.bomb_range), 10, 100, 20, BLACK);
+                    // Latncia entrada -> tela (F1 mostra, F2 troca o modo)
+                    if (input.show_latency) {
+                        double average = input.latency_count ? input.latency_sum / input.latency_count : 0.0;
+                        DrawText(TextFormat("Latencia (%s): media %.1f ms  p95 %.1f ms  max %.1f ms  [%lld]",
+                                            input.low_latency ? "baixa" : "normal", average,
+                                            InputQueueLatencyPercentile(&input, 0.95f), input.latency_max,
+                                            input.latency_count),
+                                 10, SCREEN_HEIGHT - 30, 16, DARKGRAY);
+                    }
 
                     if (game.game_over) {
                         DrawRectangle(0, 0, SCREEN_WIDTH, SCREEN_HEIGHT, Fade(BLACK, 0.5f));
@@ -276,10 +921,17 @@ int main(void) {
                     }
                     break;
             }
+            // No modo normal o EndDrawing tambm espera o prximo frame de 60 FPS,
+            // ento a medida para antes dele e no inclui a troca de buffers
+            if (!input.low_latency) InputQueueFramePresented(&input, GetTime());
         EndDrawing();
+        lastPollTime = GetTime();
+        if (input.low_latency) InputQueueFramePresented(&input, lastPollTime);
     }
 
     // Desinicializao
+    MctsShutdown(&mcts);
+    if (activeTelemetry) TelemetryStop(activeTelemetry);
     for (int i = 0; i < NUM_TEXTURES; i++) {
         UnloadTexture(game.textures[i]);
     }
@@ -287,10 +939,108 @@ int main(void) {
     return 0;
 }
 
+#endif
+
+// Teclas padro de cada jogador humano
+static const PlayerControls DEFAULT_CONTROLS[MAX_HUMAN_PLAYERS] = {
+    { KEY_W, KEY_S, KEY_A, KEY_D, KEY_SPACE },
+    { KEY_UP, KEY_DOWN, KEY_LEFT, KEY_RIGHT, KEY_RIGHT_CONTROL },
+    { KEY_I, KEY_K, KEY_J, KEY_L, KEY_O },
+    { KEY_KP_8, KEY_KP_5, KEY_KP_4, KEY_KP_6, KEY_KP_0 }
+};
+
+// Cor usada para diferenciar os jogadores
+static const Color PLAYER_TINTS[MAX_PLAYERS] = {
+    WHITE, SKYBLUE, ORANGE, LIME, PINK, YELLOW, VIOLET, GOLD
+};
+
+void ConfigurePlayers(GameState *game, int humans, int bots, BotType botType) {
+    if (humans > MAX_HUMAN_PLAYERS) humans = MAX_HUMAN_PLAYERS;
+    if (humans + bots > MAX_PLAYERS) bots = MAX_PLAYERS - humans;
+    if (humans + bots < 1) humans = 1;
+
+    game->player_count = humans + bots;
+    for (int i = 0; i < game->player_count; i++) {
+        game->players[i].is_bot = (i >= humans);
+        game->players[i].bot_type = botType;
+        if (i < humans) {
+            game->players[i].controls = DEFAULT_CONTROLS[i];
+        }
+    }
+}
+
+// Cantos do mapa e depois o meio de cada borda
+void GetSpawnPoint(int index, int *x, int *y) {
+    int far = GRID_SIZE - 2;
+    int mid = (GRID_SIZE / 2) | 1;
+    int spawns[MAX_PLAYERS][2] = {
+        { 1, 1 }, { far, far }, { far, 1 }, { 1, far },
+        { mid, 1 }, { mid, far }, { 1, mid }, { far, mid }
+    };
+    *x = spawns[index % MAX_PLAYERS][0];
+    *y = spawns[index % MAX_PLAYERS][1];
+}
+
+// Xorshift32: cada estado tem seu prprio gerador, ento cpias do jogo
+// podem ser simuladas em paralelo e de forma reproduzvel
+// Semeia o gerador a partir do rand(). O xorshift fica preso em 0, ento
+// todo estado zerado (ResetGame, memset) precisa passar por aqui.
+static void SeedGameRandom(GameState *game) {
+    game->rng = ((unsigned int)rand() << 16) ^ (unsigned int)rand() ^ 0x9E3779B9u;
+    if (game->rng == 0) game->rng = 1;
+}
+
+unsigned int GameRandom(GameState *game) {
+    if (game->rng == 0) SeedGameRandom(game);
+    unsigned int x = game->rng;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    game->rng = x;
+    return x;
+}
+
+// Publica um evento de jogo se a telemetria estiver ligada para este estado
+static void EmitEvent(GameState *game, EventType type, int player, int x, int y, int value, int other) {
+    if (!game->telemetry) return;
+
+    // O log binrio grava a struct inteira, ento o padding tambm  zerado
+    TelemetryEvent event;
+    memset(&event, 0, sizeof(TelemetryEvent));
+    event.time = GetMonotonicTime();
+    event.tick = game->tick;
+    event.value = value;
+    event.other = other;
+    event.x = (short)x;
+    event.y = (short)y;
+    event.type = (unsigned char)type;
+    event.player = (signed char)player;
+    TelemetryPublish(game->telemetry, &event);
+}
+
+// Dificuldade original do jogo
+static const DifficultyConfig DEFAULT_DIFFICULTY = {
+    .configured = true,
+    .walls_base = 40,
+    .walls_per_level = 5,
+    .enemies_base = 2,
+    .enemies_per_level = 1,
+    .bomb_fuse = 180,       // 3 segundos (60 FPS * 3)
+    .fire_ticks = 60,       // 1 segundo
+    .enemy_move_ticks = 30  // Mover a cada 0.5 segundos
+};
+
 void InitGame(GameState *game, int level) {
-    // Manter power-ups se no for o nvel 1
-    int max_bombs = (level == 1) ? 1 : game->player.max_bombs;
-    int bomb_range = (level == 1) ? 2 : game->player.bomb_range;
+    if (!game->difficulty.configured) {
+        game->difficulty = DEFAULT_DIFFICULTY;
+    }
+    DifficultyValidate(&game->difficulty);
+    if (game->player_count < 1) {
+        ConfigurePlayers(game, 1, 0, BOT_HEURISTIC);
+    }
+    if (game->rng == 0) {
+        SeedGameRandom(game);
+    }
 
     game->level = level;
     game->score = (level == 1) ? 0 : game->score; // Resetar score apenas no nvel 1
@@ -299,18 +1049,96 @@ void InitGame(GameState *game, int level) {
     game->bomb_count = 0;
     game->explosion_count = 0;
 
-    // Inicializar jogador
-    game->player.realX = 1.0f;
-    game->player.realY = 1.0f;
-    game->player.x = 1;
-    game->player.y = 1;
-    game->player.max_bombs = max_bombs;
-    game->player.bomb_range = bomb_range;
-    game->player.alive = true;
-    game->player.direction = 0; // Direita
+    // Inicializar jogadores
+    for (int i = 0; i < game->player_count; i++) {
+        Player *player = &game->players[i];
+        int x, y;
+        GetSpawnPoint(i, &x, &y);
+
+        // Manter power-ups e score se no for o nvel 1
+        if (level == 1) {
+            player->max_bombs = 1;
+            player->bomb_range = 2;
+            player->score = 0;
+        }
+
+        player->realX = (float)x;
+        player->realY = (float)y;
+        player->x = x;
+        player->y = y;
+        player->bomb_count = 0;
+        player->bot_timer = i; // Espalha as decises dos bots entre frames
+        player->alive = true;
+        player->direction = 0; // Direita
+    }
 
     // Gerar nvel
     GenerateLevel(game);
+    RebuildSpatialIndex(game);
+    EmitEvent(game, EVENT_LEVEL_START, -1, 0, 0, level, 0);
+}
+
+// Coloca os valores dentro dos limites que a simulao aceita
+void DifficultyValidate(DifficultyConfig *config) {
+    const int cells = GRID_SIZE * GRID_SIZE;
+
+    config->configured = true;
+    if (config->walls_base < 0) config->walls_base = 0;
+    if (config->walls_base > cells) config->walls_base = cells;
+    if (config->walls_per_level < 0) config->walls_per_level = 0;
+    if (config->walls_per_level > cells) config->walls_per_level = cells;
+    if (config->enemies_base < 0) config->enemies_base = 0;
+    if (config->enemies_base > MAX_ENEMIES) config->enemies_base = MAX_ENEMIES;
+    if (config->enemies_per_level < 0) config->enemies_per_level = 0;
+    if (config->enemies_per_level > MAX_ENEMIES) config->enemies_per_level = MAX_ENEMIES;
+    if (config->bomb_fuse < 1) config->bomb_fuse = 1;
+    if (config->fire_ticks < 1) config->fire_ticks = 1;
+    if (config->enemy_move_ticks < 1) config->enemy_move_ticks = 1;
+}
+
+// No colocar paredes em cima dos jogadores nem ao lado deles
+static bool IsNearSpawn(const GameState *game, int x, int y) {
+    for (int p = 0; p < game->player_count; p++) {
+        int dx = abs(x - game->players[p].x);
+        int dy = abs(y - game->players[p].y);
+        if (dx + dy <= 1) return true;
+    }
+    return false;
+}
+
+// Sorteia uma parede destrutvel que ainda no esconde nada. Com poucas
+// paredes o sorteio pode falhar; ento procura em ordem e, se nenhuma
+// servir, transforma uma clula vazia longe dos jogadores em parede.
+static bool PickHiddenCell(GameState *game, int *outX, int *outY) {
+    for (int attempt = 0; attempt < GRID_SIZE * GRID_SIZE * 4; attempt++) {
+        int x = GameRandom(game) % (GRID_SIZE-2) + 1;
+        int y = GameRandom(game) % (GRID_SIZE-2) + 1;
+        if (game->grid[y][x] == DESTRUCTIBLE && game->hiddenGrid[y][x] == EMPTY) {
+            *outX = x;
+            *outY = y;
+            return true;
+        }
+    }
+
+    int start = GameRandom(game) % (GRID_SIZE * GRID_SIZE);
+    for (int pass = 0; pass < 2; pass++) {
+        for (int i = 0; i < GRID_SIZE * GRID_SIZE; i++) {
+            int cell = (start + i) % (GRID_SIZE * GRID_SIZE);
+            int x = cell % GRID_SIZE;
+            int y = cell / GRID_SIZE;
+
+            if (pass == 0) {
+                if (game->grid[y][x] != DESTRUCTIBLE || game->hiddenGrid[y][x] != EMPTY) continue;
+            } else {
+                if (game->grid[y][x] != EMPTY || IsNearSpawn(game, x, y)) continue;
+                game->grid[y][x] = DESTRUCTIBLE;
+            }
+            *outX = x;
+            *outY = y;
+            return true;
+        }
+    }
+    return false;
 }
 
 void GenerateLevel(GameState *game) {
@@ -335,13 +1163,12 @@ void GenerateLevel(GameState *game) {
     }
 
     // Adicionar paredes destrutveis aleatrias
-    int destructibleWalls = 40 + game->level * 5;
+    int destructibleWalls = game->difficulty.walls_base + game->level * game->difficulty.walls_per_level;
     for (int i = 0; i < destructibleWalls; i++) {
-        int x = rand() % (GRID_SIZE-2) + 1;
-        int y = rand() % (GRID_SIZE-2) + 1;
+        int x = GameRandom(game) % (GRID_SIZE-2) + 1;
+        int y = GameRandom(game) % (GRID_SIZE-2) + 1;
 
-        // No colocar em cima do jogador ou em posies fixas
-        if ((x == 1 && y == 1) || (x == 1 && y == 2) || (x == 2 && y == 1)) {
+        if (IsNearSpawn(game, x, y)) {
             continue;
         }
 
@@ -351,46 +1178,40 @@ void GenerateLevel(GameState *game) {
     }
 
     // Esconder sada e power-ups sob paredes destrutveis
-    int exitX, exitY;
-    do {
-        exitX = rand() % (GRID_SIZE-2) + 1;
-        exitY = rand() % (GRID_SIZE-2) + 1;
-    } while (game->grid[exitY][exitX] != DESTRUCTIBLE);
-    game->hiddenGrid[exitY][exitX] = EXIT;
-
-    int bombPowerX, bombPowerY;
-    do {
-        bombPowerX = rand() % (GRID_SIZE-2) + 1;
-        bombPowerY = rand() % (GRID_SIZE-2) + 1;
-    } while (game->grid[bombPowerY][bombPowerX] != DESTRUCTIBLE);
-    game->hiddenGrid[bombPowerY][bombPowerX] = BOMB_POWERUP;
-
-    int rangePowerX, rangePowerY;
-    do {
-        rangePowerX = rand() % (GRID_SIZE-2) + 1;
-        rangePowerY = rand() % (GRID_SIZE-2) + 1;
-    } while (game->grid[rangePowerY][rangePowerX] != DESTRUCTIBLE);
-    game->hiddenGrid[rangePowerY][rangePowerX] = RANGE_POWERUP;
+    static const TileType hidden[] = { EXIT, BOMB_POWERUP, RANGE_POWERUP };
+    for (int i = 0; i < 3; i++) {
+        int x, y;
+        if (PickHiddenCell(game, &x, &y)) {
+            game->hiddenGrid[y][x] = hidden[i];
+        }
+    }
 
-    // Inicializar inimigos com distncia mnima do jogador
-    game->enemy_count = 2 + game->level;
+    // Inicializar inimigos com distncia mnima de todos os jogadores
+    game->enemy_count = game->difficulty.enemies_base + game->level * game->difficulty.enemies_per_level;
+    if (game->enemy_count < 0) game->enemy_count = 0;
+    if (game->enemy_count > MAX_ENEMIES) game->enemy_count = MAX_ENEMIES;
     for (int i = 0; i < game->enemy_count; i++) {
         int x, y;
         int attempts = 0;
-        int dx, dy;
+        bool nearPlayer;
 
         do {
-            x = rand() % (GRID_SIZE-2) + 1;
-            y = rand() % (GRID_SIZE-2) + 1;
+            x = GameRandom(game) % (GRID_SIZE-2) + 1;
+            y = GameRandom(game) % (GRID_SIZE-2) + 1;
             attempts++;
 
-            dx = abs(x - game->player.x);
-            dy = abs(y - game->player.y);
+            nearPlayer = false;
+            for (int p = 0; p < game->player_count; p++) {
+                int dx = abs(x - game->players[p].x);
+                int dy = abs(y - game->players[p].y);
+                if (dx < 3 && dy < 3) {
+                    nearPlayer = true;
+                    break;
+                }
+            }
 
             if (attempts > 100) break;
-        } while (game->grid[y][x] != EMPTY ||
-                 (x == 1 && y == 1) ||
-                 (dx < 3 && dy < 3));
+        } while (game->grid[y][x] != EMPTY || nearPlayer);
 
         game->enemies[i].realX = (float)x;
         game->enemies[i].realY = (float)y;
@@ -401,7 +1222,7 @@ void GenerateLevel(GameState *game) {
     }
 }
 
-void DrawGame(GameState *game) {
+void DrawGame(const Renderer *renderer, const GameState *game) {
     // Desenhar grid
     for (int y = 0; y < GRID_SIZE; y++) {
         for (int x = 0; x < GRID_SIZE; x++) {
@@ -412,22 +1233,22 @@ void DrawGame(GameState *game) {
 
             switch (game->grid[y][x]) {
                 case EMPTY:
-                    DrawTextureV(game->textures[TEX_EMPTY], position, WHITE);
+                    renderer->sprite(renderer->data, TEX_EMPTY, position, WHITE);
                     break;
                 case INDESTRUCTIBLE:
-                    DrawTextureV(game->textures[TEX_INDESTRUCTIBLE], position, WHITE);
+                    renderer->sprite(renderer->data, TEX_INDESTRUCTIBLE, position, WHITE);
                     break;
                 case DESTRUCTIBLE:
-                    DrawTextureV(game->textures[TEX_DESTRUCTIBLE], position, WHITE);
+                    renderer->sprite(renderer->data, TEX_DESTRUCTIBLE, position, WHITE);
                     break;
                 case EXIT:
-                    DrawTextureV(game->textures[TEX_EXIT], position, WHITE);
+                    renderer->sprite(renderer->data, TEX_EXIT, position, WHITE);
                     break;
                 case BOMB_POWERUP:
-                    DrawTextureV(game->textures[TEX_BOMB_POWERUP], position, WHITE);
+                    renderer->sprite(renderer->data, TEX_BOMB_POWERUP, position, WHITE);
                     break;
                 case RANGE_POWERUP:
-                    DrawTextureV(game->textures[TEX_RANGE_POWERUP], position, WHITE);
+                    renderer->sprite(renderer->data, TEX_RANGE_POWERUP, position, WHITE);
                     break;
             }
         }
@@ -439,16 +1260,18 @@ void DrawGame(GameState *game) {
             game->explosions[i].x * TILE_SIZE + (SCREEN_WIDTH - GRID_SIZE * TILE_SIZE) / 2,
             game->explosions[i].y * TILE_SIZE + 50
         };
-        DrawTextureV(game->textures[TEX_EXPLOSION], position, WHITE);
+        renderer->sprite(renderer->data, TEX_EXPLOSION, position, WHITE);
     }
 
-    // Desenhar jogador
-    if (game->player.alive) {
-        Vector2 position = {
-            game->player.realX * TILE_SIZE + (SCREEN_WIDTH - GRID_SIZE * TILE_SIZE) / 2,
-            game->player.realY * TILE_SIZE + 50
-        };
-        DrawTextureV(game->textures[TEX_PLAYER], position, WHITE);
+    // Desenhar jogadores
+    for (int i = 0; i < game->player_count; i++) {
+        if (game->players[i].alive) {
+            Vector2 position = {
+                game->players[i].realX * TILE_SIZE + (SCREEN_WIDTH - GRID_SIZE * TILE_SIZE) / 2,
+                game->players[i].realY * TILE_SIZE + 50
+            };
+            renderer->sprite(renderer->data, TEX_PLAYER, position, PLAYER_TINTS[i]);
+        }
     }
 
     // Desenhar inimigos
@@ -458,7 +1281,7 @@ void DrawGame(GameState *game) {
                 game->enemies[i].realX * TILE_SIZE + (SCREEN_WIDTH - GRID_SIZE * TILE_SIZE) / 2,
                 game->enemies[i].realY * TILE_SIZE + 50
             };
-            DrawTextureV(game->textures[TEX_ENEMY], position, WHITE);
+            renderer->sprite(renderer->data, TEX_ENEMY, position, WHITE);
         }
     }
 
@@ -469,182 +1292,596 @@ void DrawGame(GameState *game) {
                 game->bombs[i].x * TILE_SIZE + (SCREEN_WIDTH - GRID_SIZE * TILE_SIZE) / 2,
                 game->bombs[i].y * TILE_SIZE + 50
             };
-            DrawTextureV(game->textures[TEX_BOMB], position, WHITE);
+            renderer->sprite(renderer->data, TEX_BOMB, position, WHITE);
         }
     }
 }
 
-void UpdateGame(GameState *game) {
-    // Movimentao do jogador
-    if (game->player.alive) {
-        int targetX = game->player.x;
-        int targetY = game->player.y;
+// Informaes da partida no topo da tela. Usa um buffer local em vez de
+// TextFormat para poder ser chamada por vrias threads.
+void DrawHud(const Renderer *renderer, const GameState *game) {
+    char text[64];
 
-        if (IsKeyPressed(KEY_RIGHT) || IsKeyPressed(KEY_D)) {
-            targetX++;
-            game->player.direction = 0;
-        }
-        if (IsKeyPressed(KEY_LEFT) || IsKeyPressed(KEY_A)) {
-            targetX--;
-            game->player.direction = 1;
-        }
-        if (IsKeyPressed(KEY_UP) || IsKeyPressed(KEY_W)) {
-            targetY--;
-            game->player.direction = 2;
-        }
-        if (IsKeyPressed(KEY_DOWN) || IsKeyPressed(KEY_S)) {
-            targetY++;
-            game->player.direction = 3;
+    snprintf(text, sizeof(text), "Fase: %d", game->level);
+    renderer->text(renderer->data, text, 10, 10, 20, BLACK);
+
+    if (game->player_count == 1) {
+        snprintf(text, sizeof(text), "Score: %d", game->score);
+        renderer->text(renderer->data, text, 10, 40, 20, BLACK);
+        snprintf(text, sizeof(text), "Bombas: %d/%d", game->players[0].max_bombs - game->players[0].bomb_count, game->players[0].max_bombs);
+        renderer->text(renderer->data, text, 10, 70, 20, BLACK);
+        snprintf(text, sizeof(text), "Alcance: %d", game->players[0].bomb_range);
+        renderer->text(renderer->data, text, 10, 100, 20, BLACK);
+    } else {
+        // Uma linha por jogador, em duas colunas
+        for (int i = 0; i < game->player_count; i++) {
+            const Player *p = &game->players[i];
+            snprintf(text, sizeof(text), "%s%d: %d pts B%d/%d A%d", p->is_bot ? "Bot" : "J", i + 1, p->score,
+                     p->max_bombs - p->bomb_count, p->max_bombs, p->bomb_range);
+            renderer->text(renderer->data, text, 10 + (i / 4) * 400, 30 + (i % 4) * 20, 16, p->alive ? BLACK : GRAY);
         }
+    }
+}
 
-        // Verificar se a movimentao  vlida
-        if (targetX != game->player.x || targetY != game->player.y) {
-            if (targetX >= 0 && targetX < GRID_SIZE && targetY >= 0 && targetY < GRID_SIZE) {
-                TileType tile = game->grid[targetY][targetX];
+// Backend raylib: data aponta para as texturas carregadas (NUM_TEXTURES)
+static void RaylibSprite(void *data, TextureType texture, Vector2 position, Color tint) {
+    Texture2D *textures = (Texture2D *)data;
+    DrawTextureV(textures[texture], position, tint);
+}
 
-                // Verificar se h bomba no caminho
-                bool hasBomb = false;
-                for (int i = 0; i < game->bomb_count; i++) {
-                    if (!game->bombs[i].exploded &&
-                        game->bombs[i].x == targetX &&
-                        game->bombs[i].y == targetY) {
-                        hasBomb = true;
-                        break;
-                    }
-                }
+static void RaylibRect(void *data, int x, int y, int width, int height, Color color) {
+    (void)data;
+    DrawRectangle(x, y, width, height, color);
+}
 
-                if (!hasBomb && (tile == EMPTY || tile == EXIT || tile == BOMB_POWERUP || tile == RANGE_POWERUP)) {
-                    game->player.x = targetX;
-                    game->player.y = targetY;
-                }
-            }
-        }
+static void RaylibText(void *data, const char *text, int x, int y, int size, Color color) {
+    (void)data;
+    DrawText(text, x, y, size, color);
+}
 
-        // Interpolao suave da posio
-        float speed = 5.0f * GetFrameTime();
-        game->player.realX += (game->player.x - game->player.realX) * speed;
-        game->player.realY += (game->player.y - game->player.realY) * speed;
+Renderer RaylibRenderer(Texture2D *textures) {
+    Renderer renderer = { textures, RaylibSprite, RaylibRect, RaylibText };
+    return renderer;
+}
 
-        // Coletar power-ups ao passar sobre eles
-        TileType currentTile = game->grid[game->player.y][game->player.x];
-        if (currentTile == BOMB_POWERUP) {
-            game->player.max_bombs++;
-            game->grid[game->player.y][game->player.x] = EMPTY;
-        }
-        else if (currentTile == RANGE_POWERUP) {
-            game->player.bomb_range++;
-            game->grid[game->player.y][game->player.x] = EMPTY;
-        }
-        else if (currentTile == EXIT) {
-            // Verificar se todos os inimigos esto mortos
-            bool allEnemiesDead = true;
-            for (int i = 0; i < game->enemy_count; i++) {
-                if (game->enemies[i].alive) {
-                    allEnemiesDead = false;
-                    break;
-                }
-            }
+// ---------------------------------------------------------------------------
+// ndice espacial
+// ---------------------------------------------------------------------------
 
-            if (allEnemiesDead) {
-                game->level_complete = true;
-            }
-        }
+static void SpatialPush(short head[GRID_SIZE][GRID_SIZE], short *next, int i, int x, int y) {
+    next[i] = head[y][x];
+    head[y][x] = (short)i;
+}
 
-        // Plantar bomba
-        if (IsKeyPressed(KEY_SPACE)) {
-            PlantBomb(game);
+static void SpatialUnlink(short head[GRID_SIZE][GRID_SIZE], short *next, int i, int x, int y) {
+    short *link = &head[y][x];
+    while (*link >= 0) {
+        if (*link == i) {
+            *link = next[i];
+            return;
         }
+        link = &next[*link];
     }
+}
 
-    // Atualizar bombas
-    for (int i = 0; i < game->bomb_count; i++) {
-        if (!game->bombs[i].exploded) {
-            game->bombs[i].timer--;
+void RebuildSpatialIndex(GameState *game) {
+    SpatialIndex *index = &game->index;
 
-            if (game->bombs[i].timer <= 0) {
-                ExplodeBomb(game, &game->bombs[i]);
-            }
+    memset(index->bomb, 0, sizeof(index->bomb));
+    for (int y = 0; y < GRID_SIZE; y++) {
+        for (int x = 0; x < GRID_SIZE; x++) {
+            index->enemy[y][x] = -1;
+            index->player[y][x] = -1;
         }
     }
 
-    // Remover bombas explodidas
     for (int i = 0; i < game->bomb_count; i++) {
-        if (game->bombs[i].exploded) {
-            for (int j = i; j < game->bomb_count - 1; j++) {
-                game->bombs[j] = game->bombs[j+1];
-            }
-            game->bomb_count--;
-            i--;
+        if (!game->bombs[i].exploded) {
+            index->bomb[game->bombs[i].y][game->bombs[i].x] = (unsigned char)(i + 1);
         }
     }
+    for (int i = 0; i < game->enemy_count; i++) {
+        SpatialPush(index->enemy, index->enemyNext, i, game->enemies[i].x, game->enemies[i].y);
+    }
+    for (int i = 0; i < game->player_count; i++) {
+        SpatialPush(index->player, index->playerNext, i, game->players[i].x, game->players[i].y);
+    }
+}
 
-    // Atualizar exploses
-    for (int i = 0; i < game->explosion_count; i++) {
-        game->explosions[i].timer--;
-        if (game->explosions[i].timer <= 0) {
-            for (int j = i; j < game->explosion_count - 1; j++) {
-                game->explosions[j] = game->explosions[j+1];
-            }
-            game->explosion_count--;
-            i--;
+bool IsWalkable(const GameState *game, int x, int y) {
+    if (x < 0 || x >= GRID_SIZE || y < 0 || y >= GRID_SIZE) return false;
+    if (game->index.bomb[y][x]) return false;
+
+    TileType tile = game->grid[y][x];
+    return tile == EMPTY || tile == EXIT || tile == BOMB_POWERUP || tile == RANGE_POWERUP;
+}
+
+// Mata todos os jogadores na clula; o jogo acaba quando no sobra nenhum.
+// killer  o dono da bomba (-1 se a morte no foi por exploso).
+static void KillPlayersAt(GameState *game, int x, int y, DeathCause cause, int killer) {
+    for (int i = game->index.player[y][x]; i >= 0; i = game->index.playerNext[i]) {
+        if (game->players[i].alive) {
+            game->players[i].alive = false;
+            game->players[i].death_cause = cause;
+            game->players[i].killed_by = killer;
+            EmitEvent(game, EVENT_PLAYER_DEATH, i, x, y, cause, killer);
         }
     }
 
-    // Movimentar inimigos
-    MoveEnemies(game);
-
-    // Verificar coliso entre jogador e inimigos
-    for (int i = 0; i < game->enemy_count; i++) {
-        if (game->enemies[i].alive &&
-            game->player.x == game->enemies[i].x &&
-            game->player.y == game->enemies[i].y) {
-            game->player.alive = false;
-            game->game_over = true;
+    bool anyAlive = false;
+    for (int i = 0; i < game->player_count; i++) {
+        if (game->players[i].alive) {
+            anyAlive = true;
+            break;
         }
     }
+    if (!anyAlive && !game->game_over) {
+        game->game_over = true;
+        EmitEvent(game, EVENT_GAME_OVER, -1, x, y, game->level, 0);
+    }
 }
 
-void PlantBomb(GameState *game) {
-    if (game->bomb_count < game->player.max_bombs) {
-        // Verificar se j no h bomba nesta posio
-        bool bombAlreadyHere = false;
-        for (int i = 0; i < game->bomb_count; i++) {
-            if (game->bombs[i].x == game->player.x && game->bombs[i].y == game->player.y) {
-                bombAlreadyHere = true;
-                break;
-            }
-        }
+// ---------------------------------------------------------------------------
+// Entrada
+// ---------------------------------------------------------------------------
 
-        if (!bombAlreadyHere) {
-            Bomb newBomb = {
-                .x = game->player.x,
-                .y = game->player.y,
-                .timer = 180, // 3 segundos (60 FPS * 3)
-                .range = game->player.bomb_range,
-                .exploded = false
+void InputQueueInit(InputQueue *queue) {
+    memset(queue, 0, sizeof(InputQueue));
+}
+
+// Converte uma tecla nos comandos do jogador que a usa
+static bool MapKeyToInput(const GameState *game, int key, int *player, PlayerInput *input) {
+    int humans = 0;
+    for (int i = 0; i < game->player_count; i++) {
+        if (!game->players[i].is_bot) humans++;
+    }
+
+    for (int i = 0; i < game->player_count; i++) {
+        const Player *p = &game->players[i];
+        if (p->is_bot) continue;
+
+        const PlayerControls *keys = &p->controls;
+        // Com um s jogador humano as setas tambm funcionam
+        const PlayerControls *alt = (humans == 1) ? &DEFAULT_CONTROLS[1] : keys;
+
+        memset(input, 0, sizeof(PlayerInput));
+        if (key == keys->right || key == alt->right) input->dx = 1;
+        else if (key == keys->left || key == alt->left) input->dx = -1;
+        else if (key == keys->up || key == alt->up) input->dy = -1;
+        else if (key == keys->down || key == alt->down) input->dy = 1;
+        else if (key == keys->bomb) input->bomb = true;
+        else continue;
+
+        *player = i;
+        return true;
+    }
+    return false;
+}
+
+// L todas as teclas pressionadas desde a ltima leitura, em ordem, pela
+// fila do raylib. Assim toques rpidos (apertar e soltar dentro do mesmo
+// frame) no se perdem como aconteceria com IsKeyPressed. O instante
+// registrado  o da leitura, no o do evento do sistema, ento as
+// latncias medidas so um limite inferior.
+void InputQueuePoll(InputQueue *queue, const GameState *game, double time) {
+    int key = GetKeyPressed();
+    while (key > 0) {
+        InputEvent event;
+        if (MapKeyToInput(game, key, &event.player, &event.input)) {
+            event.time = time;
+            if (queue->count == INPUT_QUEUE_SIZE) {
+                // Fila cheia: descarta o evento mais antigo
+                memmove(&queue->events[0], &queue->events[1], sizeof(InputEvent) * (INPUT_QUEUE_SIZE - 1));
+                queue->count--;
+                queue->dropped++;
+            }
+            queue->events[queue->count++] = event;
+        }
+        else if (queue->frame_key_count < 16) {
+            queue->frame_keys[queue->frame_key_count++] = key;
+        }
+        key = GetKeyPressed();
+    }
+}
+
+// Remove o evento mais antigo do jogador e marca-o para medir a latncia
+bool InputQueuePop(InputQueue *queue, int player, PlayerInput *input) {
+    for (int i = 0; i < queue->count; i++) {
+        if (queue->events[i].player != player) continue;
+
+        *input = queue->events[i].input;
+        if (queue->applied_count < INPUT_QUEUE_SIZE) {
+            queue->applied[queue->applied_count++] = queue->events[i].time;
+        }
+        memmove(&queue->events[i], &queue->events[i + 1], sizeof(InputEvent) * (queue->count - i - 1));
+        queue->count--;
+        return true;
+    }
+    return false;
+}
+
+// Teclas que no so de jogo (ex: F1, F2) lidas pela fila neste frame
+bool InputQueueKeyPressed(const InputQueue *queue, int key) {
+    for (int i = 0; i < queue->frame_key_count; i++) {
+        if (queue->frame_keys[i] == key) return true;
+    }
+    return false;
+}
+
+// Chamado quando o frame  apresentado (antes do EndDrawing no modo normal,
+// logo depois dele no de baixa latncia): os eventos aplicados at aqui
+// aparecem neste frame
+void InputQueueFramePresented(InputQueue *queue, double time) {
+    for (int i = 0; i < queue->applied_count; i++) {
+        double latency = (time - queue->applied[i]) * 1000.0;
+        queue->samples[queue->sample_next] = (float)latency;
+        queue->sample_next = (queue->sample_next + 1) % LATENCY_SAMPLES;
+        if (queue->sample_count < LATENCY_SAMPLES) queue->sample_count++;
+        queue->latency_sum += latency;
+        if (latency > queue->latency_max) queue->latency_max = latency;
+        queue->latency_count++;
+    }
+    queue->applied_count = 0;
+    queue->frame_key_count = 0;
+}
+
+void InputQueueResetLatency(InputQueue *queue) {
+    queue->sample_count = 0;
+    queue->sample_next = 0;
+    queue->latency_sum = 0.0;
+    queue->latency_max = 0.0;
+    queue->latency_count = 0;
+}
+
+static int CompareFloats(const void *a, const void *b) {
+    float fa = *(const float *)a;
+    float fb = *(const float *)b;
+    return (fa > fb) - (fa < fb);
+}
+
+// Percentil (0 a 1) das ltimas LATENCY_SAMPLES latncias, em ms
+float InputQueueLatencyPercentile(const InputQueue *queue, float percentile) {
+    float sorted[LATENCY_SAMPLES];
+    if (queue->sample_count == 0) return 0.0f;
+
+    memcpy(sorted, queue->samples, sizeof(float) * queue->sample_count);
+    qsort(sorted, queue->sample_count, sizeof(float), CompareFloats);
+
+    int index = (int)(percentile * (queue->sample_count - 1) + 0.5f);
+    return sorted[index];
+}
+
+// Marca as clulas que sero atingidas pelas bombas armadas
+static void BuildDangerMap(const GameState *game, bool danger[GRID_SIZE][GRID_SIZE]) {
+    int dx[] = {0, 0, -1, 1};
+    int dy[] = {-1, 1, 0, 0};
+
+    memset(danger, 0, sizeof(bool) * GRID_SIZE * GRID_SIZE);
+    for (int i = 0; i < game->bomb_count; i++) {
+        const Bomb *bomb = &game->bombs[i];
+        if (bomb->exploded) continue;
+
+        danger[bomb->y][bomb->x] = true;
+        for (int d = 0; d < 4; d++) {
+            for (int r = 1; r <= bomb->range; r++) {
+                int x = bomb->x + dx[d] * r;
+                int y = bomb->y + dy[d] * r;
+                if (x < 0 || x >= GRID_SIZE || y < 0 || y >= GRID_SIZE) break;
+                if (game->grid[y][x] == INDESTRUCTIBLE) break;
+                danger[y][x] = true;
+                if (game->grid[y][x] == DESTRUCTIBLE) break;
+            }
+        }
+    }
+    for (int i = 0; i < game->explosion_count; i++) {
+        danger[game->explosions[i].y][game->explosions[i].x] = true;
+    }
+}
+
+// Busca em largura at a clula segura mais prxima; devolve o primeiro passo.
+// Retorna false se no houver clula segura alcanvel em maxSteps.
+static bool FindSafeStep(const GameState *game, bool danger[GRID_SIZE][GRID_SIZE],
+                         int startX, int startY, int maxSteps, int *stepX, int *stepY) {
+    int dx[] = {0, 0, -1, 1};
+    int dy[] = {-1, 1, 0, 0};
+    short queue[GRID_SIZE * GRID_SIZE];
+    short first[GRID_SIZE * GRID_SIZE];  // Primeiro passo usado para chegar  clula
+    unsigned char dist[GRID_SIZE * GRID_SIZE];
+    bool seen[GRID_SIZE * GRID_SIZE] = {0};
+    int head = 0, tail = 0;
+
+    int start = startY * GRID_SIZE + startX;
+    queue[tail++] = (short)start;
+    first[start] = (short)start;
+    dist[start] = 0;
+    seen[start] = true;
+
+    while (head < tail) {
+        int cell = queue[head++];
+        int cx = cell % GRID_SIZE;
+        int cy = cell / GRID_SIZE;
+
+        if (!danger[cy][cx]) {
+            *stepX = first[cell] % GRID_SIZE;
+            *stepY = first[cell] / GRID_SIZE;
+            return true;
+        }
+        if (dist[cell] >= maxSteps) continue;
+
+        for (int d = 0; d < 4; d++) {
+            int nx = cx + dx[d];
+            int ny = cy + dy[d];
+            if (!IsWalkable(game, nx, ny)) continue;
+            int next = ny * GRID_SIZE + nx;
+            if (seen[next]) continue;
+            seen[next] = true;
+            first[next] = (cell == start) ? (short)next : first[cell];
+            dist[next] = dist[cell] + 1;
+            queue[tail++] = (short)next;
+        }
+    }
+    return false;
+}
+
+// Bot simples: foge do perigo, planta bombas perto de paredes e inimigos
+// quando tem rota de fuga, e anda aleatoriamente pelo resto do tempo
+void BotInput(GameState *game, int index, PlayerInput *input) {
+    const Player *bot = &game->players[index];
+    bool danger[GRID_SIZE][GRID_SIZE];
+    int dx[] = {0, 0, -1, 1};
+    int dy[] = {-1, 1, 0, 0};
+
+    input->dx = 0;
+    input->dy = 0;
+    input->bomb = false;
+    if (!bot->alive) return;
+
+    BuildDangerMap(game, danger);
+
+    int stepX, stepY;
+    if (danger[bot->y][bot->x]) {
+        if (FindSafeStep(game, danger, bot->x, bot->y, GRID_SIZE, &stepX, &stepY)) {
+            input->dx = stepX - bot->x;
+            input->dy = stepY - bot->y;
+        }
+        return;
+    }
+
+    // Plantar bomba se houver alvo ao lado e for possvel escapar dela
+    bool target = false;
+    for (int d = 0; d < 4 && !target; d++) {
+        int x = bot->x + dx[d];
+        int y = bot->y + dy[d];
+        if (x < 0 || x >= GRID_SIZE || y < 0 || y >= GRID_SIZE) continue;
+        if (game->grid[y][x] == DESTRUCTIBLE || game->index.enemy[y][x] >= 0) target = true;
+    }
+    if (target && bot->bomb_count < bot->max_bombs) {
+        bool withBomb[GRID_SIZE][GRID_SIZE];
+        memcpy(withBomb, danger, sizeof(withBomb));
+        withBomb[bot->y][bot->x] = true;
+        for (int d = 0; d < 4; d++) {
+            for (int r = 1; r <= bot->bomb_range; r++) {
+                int x = bot->x + dx[d] * r;
+                int y = bot->y + dy[d] * r;
+                if (x < 0 || x >= GRID_SIZE || y < 0 || y >= GRID_SIZE) break;
+                if (game->grid[y][x] == INDESTRUCTIBLE) break;
+                withBomb[y][x] = true;
+                if (game->grid[y][x] == DESTRUCTIBLE) break;
+            }
+        }
+        if (FindSafeStep(game, withBomb, bot->x, bot->y, 4, &stepX, &stepY)) {
+            input->bomb = true;
+            return;
+        }
+    }
+
+    // Andar para uma clula vizinha segura aleatria
+    int options[4];
+    int count = 0;
+    for (int d = 0; d < 4; d++) {
+        int x = bot->x + dx[d];
+        int y = bot->y + dy[d];
+        if (IsWalkable(game, x, y) && !danger[y][x] && game->index.enemy[y][x] < 0) {
+            options[count++] = d;
+        }
+    }
+    if (count > 0) {
+        int d = options[GameRandom(game) % count];
+        input->dx = dx[d];
+        input->dy = dy[d];
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Simulao
+// ---------------------------------------------------------------------------
+
+// Um tick da simulao: entrada dos humanos vem da fila, a dos bots da IA
+void UpdateGame(GameState *game, MctsSearch *mcts, InputQueue *queue) {
+    PlayerInput inputs[MAX_PLAYERS];
+
+    for (int i = 0; i < game->player_count; i++) {
+        Player *player = &game->players[i];
+        memset(&inputs[i], 0, sizeof(PlayerInput));
+
+        if (!player->is_bot) {
+            if (queue) InputQueuePop(queue, i, &inputs[i]);
+        }
+        else if (++player->bot_timer >= BOT_THINK_TICKS) {
+            player->bot_timer = 0;
+            if (player->bot_type == BOT_MCTS && mcts && player->alive) {
+                MctsChooseInput(mcts, game, i, MCTS_BUDGET, &inputs[i]);
+            } else {
+                BotInput(game, i, &inputs[i]);
+            }
+        }
+    }
+
+    StepGame(game, inputs, (float)SIM_DT);
+}
+
+void StepGame(GameState *game, const PlayerInput *inputs, float dt) {
+    game->tick++;
+    RebuildSpatialIndex(game);
+
+    // Movimentao dos jogadores
+    for (int p = 0; p < game->player_count; p++) {
+        Player *player = &game->players[p];
+        if (!player->alive) continue;
+
+        const PlayerInput *input = &inputs[p];
+        int targetX = player->x + input->dx;
+        int targetY = player->y + input->dy;
+
+        if (input->dy > 0) player->direction = 3;
+        else if (input->dy < 0) player->direction = 2;
+        else if (input->dx < 0) player->direction = 1;
+        else if (input->dx > 0) player->direction = 0;
+
+        // Verificar se a movimentao  vlida (paredes e bombas no caminho)
+        if ((targetX != player->x || targetY != player->y) && IsWalkable(game, targetX, targetY)) {
+            SpatialUnlink(game->index.player, game->index.playerNext, p, player->x, player->y);
+            player->x = targetX;
+            player->y = targetY;
+            SpatialPush(game->index.player, game->index.playerNext, p, player->x, player->y);
+        }
+
+        // Interpolao suave da posio
+        float speed = 5.0f * dt;
+        player->realX += (player->x - player->realX) * speed;
+        player->realY += (player->y - player->realY) * speed;
+
+        // Coletar power-ups ao passar sobre eles
+        TileType currentTile = game->grid[player->y][player->x];
+        if (currentTile == BOMB_POWERUP) {
+            player->max_bombs++;
+            game->grid[player->y][player->x] = EMPTY;
+            EmitEvent(game, EVENT_POWERUP, p, player->x, player->y, BOMB_POWERUP, 0);
+        }
+        else if (currentTile == RANGE_POWERUP) {
+            player->bomb_range++;
+            game->grid[player->y][player->x] = EMPTY;
+            EmitEvent(game, EVENT_POWERUP, p, player->x, player->y, RANGE_POWERUP, 0);
+        }
+        else if (currentTile == EXIT) {
+            // Verificar se todos os inimigos esto mortos
+            bool allEnemiesDead = true;
+            for (int i = 0; i < game->enemy_count; i++) {
+                if (game->enemies[i].alive) {
+                    allEnemiesDead = false;
+                    break;
+                }
+            }
+
+            if (allEnemiesDead && !game->level_complete) {
+                game->level_complete = true;
+                EmitEvent(game, EVENT_LEVEL_COMPLETE, p, player->x, player->y, game->level, 0);
+            }
+        }
+
+        // Plantar bomba
+        if (input->bomb) {
+            PlantBomb(game, p);
+        }
+    }
+
+    // Atualizar bombas
+    for (int i = 0; i < game->bomb_count; i++) {
+        if (!game->bombs[i].exploded) {
+            game->bombs[i].timer--;
+
+            if (game->bombs[i].timer <= 0) {
+                ExplodeBomb(game, &game->bombs[i]);
+            }
+        }
+    }
+
+    // Remover bombas explodidas, mantendo o ndice espacial em dia
+    int remaining = 0;
+    for (int i = 0; i < game->bomb_count; i++) {
+        Bomb *bomb = &game->bombs[i];
+        if (bomb->exploded) {
+            game->index.bomb[bomb->y][bomb->x] = 0;
+        } else {
+            game->bombs[remaining] = *bomb;
+            game->index.bomb[bomb->y][bomb->x] = (unsigned char)(remaining + 1);
+            remaining++;
+        }
+    }
+    game->bomb_count = remaining;
+
+    // Atualizar exploses
+    for (int i = 0; i < game->explosion_count; i++) {
+        game->explosions[i].timer--;
+        if (game->explosions[i].timer <= 0) {
+            for (int j = i; j < game->explosion_count - 1; j++) {
+                game->explosions[j] = game->explosions[j+1];
+            }
+            game->explosion_count--;
+            i--;
+        }
+    }
+
+    // Movimentar inimigos
+    MoveEnemies(game, dt);
+
+    // Verificar coliso entre jogadores e inimigos
+    for (int p = 0; p < game->player_count; p++) {
+        Player *player = &game->players[p];
+        if (!player->alive) continue;
+
+        for (int i = game->index.enemy[player->y][player->x]; i >= 0; i = game->index.enemyNext[i]) {
+            if (game->enemies[i].alive) {
+                KillPlayersAt(game, player->x, player->y, DEATH_ENEMY, -1);
+                break;
+            }
+        }
+    }
+}
+
+void PlantBomb(GameState *game, int owner) {
+    Player *player = &game->players[owner];
+
+    if (player->bomb_count < player->max_bombs &&
+        player->bomb_count < MAX_BOMBS_PER_PLAYER &&
+        game->bomb_count < MAX_BOMBS) {
+        // Verificar se j no h bomba nesta posio
+        if (!game->index.bomb[player->y][player->x]) {
+            Bomb newBomb = {
+                .x = player->x,
+                .y = player->y,
+                .timer = game->difficulty.bomb_fuse,
+                .range = player->bomb_range,
+                .owner = owner,
+                .exploded = false
             };
 
             game->bombs[game->bomb_count] = newBomb;
             game->bomb_count++;
+            game->index.bomb[newBomb.y][newBomb.x] = (unsigned char)game->bomb_count;
+            player->bomb_count++;
+            EmitEvent(game, EVENT_BOMB_PLANTED, owner, newBomb.x, newBomb.y, newBomb.range, 0);
         }
     }
 }
 
 void ExplodeBomb(GameState *game, Bomb *bomb) {
     bomb->exploded = true;
+    if (bomb->owner >= 0 && bomb->owner < game->player_count) {
+        game->players[bomb->owner].bomb_count--;
+    }
 
     // Adicionar exploso central
     if (game->explosion_count < MAX_EXPLOSIONS) {
         game->explosions[game->explosion_count].x = bomb->x;
         game->explosions[game->explosion_count].y = bomb->y;
-        game->explosions[game->explosion_count].timer = 60; // 1 segundo
+        game->explosions[game->explosion_count].timer = game->difficulty.fire_ticks;
         game->explosion_count++;
     }
 
-    // Exploso central - verifica se jogador ainda est na posio
-    if (bomb->x == game->player.x && bomb->y == game->player.y) {
-        game->player.alive = false;
-        game->game_over = true;
+    // Exploso central - verifica se algum jogador ainda est na posio
+    if (game->index.player[bomb->y][bomb->x] >= 0) {
+        KillPlayersAt(game, bomb->x, bomb->y, DEATH_EXPLOSION, bomb->owner);
     }
 
     // Direes: cima, baixo, esquerda, direita
@@ -668,7 +1905,7 @@ void ExplodeBomb(GameState *game, Bomb *bomb) {
             if (game->explosion_count < MAX_EXPLOSIONS) {
                 game->explosions[game->explosion_count].x = x;
                 game->explosions[game->explosion_count].y = y;
-                game->explosions[game->explosion_count].timer = 60; // 1 segundo
+                game->explosions[game->explosion_count].timer = game->difficulty.fire_ticks;
                 game->explosion_count++;
             }
 
@@ -684,44 +1921,43 @@ void ExplodeBomb(GameState *game, Bomb *bomb) {
                 break; // A exploso para aps destruir a parede
             }
 
-            // Matar inimigos
-            for (int i = 0; i < game->enemy_count; i++) {
-                if (game->enemies[i].alive &&
-                    game->enemies[i].x == x &&
-                    game->enemies[i].y == y) {
+            // Matar inimigos (pontos para o dono da bomba)
+            for (int i = game->index.enemy[y][x]; i >= 0; i = game->index.enemyNext[i]) {
+                if (game->enemies[i].alive) {
                     game->enemies[i].alive = false;
                     game->score += 100;
+                    if (bomb->owner >= 0 && bomb->owner < game->player_count) {
+                        game->players[bomb->owner].score += 100;
+                    }
+                    EmitEvent(game, EVENT_ENEMY_KILLED, bomb->owner, x, y, 100, 0);
+                    EmitEvent(game, EVENT_SCORE, bomb->owner, x, y, 100, game->score);
                 }
             }
 
-            // Matar jogador
-            if (game->player.x == x && game->player.y == y) {
-                game->player.alive = false;
-                game->game_over = true;
+            // Matar jogadores
+            if (game->index.player[y][x] >= 0) {
+                KillPlayersAt(game, x, y, DEATH_EXPLOSION, bomb->owner);
             }
 
             // Detonar outras bombas
-            for (int i = 0; i < game->bomb_count; i++) {
-                if (!game->bombs[i].exploded &&
-                    game->bombs[i].x == x &&
-                    game->bombs[i].y == y) {
-                    game->bombs[i].timer = 0;
-                }
+            int other = game->index.bomb[y][x];
+            if (other && !game->bombs[other - 1].exploded) {
+                game->bombs[other - 1].timer = 0;
             }
         }
     }
 }
 
-void MoveEnemies(GameState *game) {
+void MoveEnemies(GameState *game, float dt) {
     for (int i = 0; i < game->enemy_count; i++) {
         if (game->enemies[i].alive) {
             game->enemies[i].move_timer++;
 
-            if (game->enemies[i].move_timer >= 30) { // Mover a cada 0.5 segundos
+            if (game->enemies[i].move_timer >= game->difficulty.enemy_move_ticks) {
                 game->enemies[i].move_timer = 0;
 
                 // IA simples: mover aleatoriamente
-                int direction = rand() % 4;
+                int direction = GameRandom(game) % 4;
                 int newX = game->enemies[i].x;
                 int newY = game->enemies[i].y;
 
@@ -732,43 +1968,68 @@ void MoveEnemies(GameState *game) {
                     case 3: newY--; break; // Cima
                 }
 
-                // Verificar se o movimento  vlido
-                if (newX >= 0 && newX < GRID_SIZE && newY >= 0 && newY < GRID_SIZE) {
-                    TileType tile = game->grid[newY][newX];
-
-                    // Verificar se h bomba no caminho
-                    bool hasBomb = false;
-                    for (int j = 0; j < game->bomb_count; j++) {
-                        if (!game->bombs[j].exploded &&
-                            game->bombs[j].x == newX &&
-                            game->bombs[j].y == newY) {
-                            hasBomb = true;
-                            break;
-                        }
-                    }
-
-                    if (!hasBomb && (tile == EMPTY || tile == EXIT || tile == BOMB_POWERUP || tile == RANGE_POWERUP)) {
-                        game->enemies[i].x = newX;
-                        game->enemies[i].y = newY;
-                    }
+                // Verificar se o movimento  vlido (paredes e bombas no caminho)
+                if (IsWalkable(game, newX, newY)) {
+                    SpatialUnlink(game->index.enemy, game->index.enemyNext, i, game->enemies[i].x, game->enemies[i].y);
+                    game->enemies[i].x = newX;
+                    game->enemies[i].y = newY;
+                    SpatialPush(game->index.enemy, game->index.enemyNext, i, newX, newY);
                 }
             }
 
             // Interpolao suave da posio
-            float speed = 5.0f * GetFrameTime();
+            float speed = 5.0f * dt;
             game->enemies[i].realX += (game->enemies[i].x - game->enemies[i].realX) * speed;
             game->enemies[i].realY += (game->enemies[i].y - game->enemies[i].realY) * speed;
         }
     }
 }
 
+// Partida s de bots, sem janela (./bomberman --bot-match [jogadores] [ticks])
+void RunBotMatch(int players, int maxTicks, Telemetry *telemetry) {
+    static GameState game;
+
+    if (players < 1) players = 1;
+    if (players > MAX_PLAYERS) players = MAX_PLAYERS;
+
+    srand((unsigned int)time(NULL));
+    memset(&game, 0, sizeof(GameState));
+    game.telemetry = telemetry;
+    ConfigurePlayers(&game, 0, players, BOT_HEURISTIC);
+    InitGame(&game, 1);
+
+    int tick = 0;
+    while (tick < maxTicks && !game.game_over) {
+        UpdateGame(&game, NULL, NULL);
+        tick++;
+
+        if (game.level_complete) {
+            printf("Fase %d completa no tick %d\n", game.level, tick);
+            if (game.level >= MAX_LEVELS) break;
+            InitGame(&game, game.level + 1);
+        }
+    }
+
+    printf("Fim: fase %d, %d ticks, %s\n", game.level, tick, game.game_over ? "todos morreram" : "sobreviveram");
+    for (int i = 0; i < game.player_count; i++) {
+        printf("  Bot %d: %d pts, bombas %d, alcance %d, %s\n", i + 1, game.players[i].score,
+               game.players[i].max_bombs, game.players[i].bomb_range, game.players[i].alive ? "vivo" : "morto");
+    }
+}
+
 void LoadCustomMap(GameState *game, const char *filename) {
     FILE *file = fopen(filename, "r");
     if (!file) return;
 
-    // Resetar jogo
+    // Resetar jogo, mantendo a configurao de jogadores
+    int playerCount = game->player_count;
+    Player players[MAX_PLAYERS];
+    memcpy(players, game->players, sizeof(players));
     ResetGame(game);
+    SeedGameRandom(game);
     game->level = 1;
+    game->player_count = playerCount > 0 ? playerCount : 1;
+    memcpy(game->players, players, sizeof(players));
 
     // Inicializar hiddenGrid
     for (int y = 0; y < GRID_SIZE; y++) {
@@ -791,11 +2052,22 @@ void LoadCustomMap(GameState *game, const char *filename) {
         fgetc(file); // Pular nova linha
     }
 
-    // Posicionar jogador
-    game->player.realX = 1.0f;
-    game->player.realY = 1.0f;
-    game->player.x = 1;
-    game->player.y = 1;
+    // Posicionar jogadores
+    for (int i = 0; i < game->player_count; i++) {
+        Player *player = &game->players[i];
+        int x, y;
+        GetSpawnPoint(i, &x, &y);
+        player->realX = (float)x;
+        player->realY = (float)y;
+        player->x = x;
+        player->y = y;
+        player->max_bombs = 1;
+        player->bomb_range = 2;
+        player->bomb_count = 0;
+        player->score = 0;
+        player->alive = true;
+        player->direction = 0;
+    }
 
     // Adicionar alguns inimigos
     game->enemy_count = 3;
@@ -809,25 +2081,2429 @@ void LoadCustomMap(GameState *game, const char *filename) {
     }
 
     fclose(file);
+    RebuildSpatialIndex(game);
 }
 
+// Cabealho do save.bin: o GameState  gravado cru, ento saves de verses
+// com outro layout (ou outro GRID_SIZE) precisam ser recusados
+#define SAVE_MAGIC 0x53564D42u  // "BMVS"
+#define SAVE_VERSION 3u
+
+typedef struct {
+    unsigned int magic;
+    unsigned int version;
+    unsigned int size;      // sizeof(GameState)
+} SaveHeader;
+
 void SaveGame(GameState *game) {
     FILE *file = fopen("save.bin", "wb");
     if (!file) return;
 
+    SaveHeader header = { SAVE_MAGIC, SAVE_VERSION, (unsigned int)sizeof(GameState) };
+    fwrite(&header, sizeof(SaveHeader), 1, file);
     fwrite(game, sizeof(GameState), 1, file);
     fclose(file);
 }
 
+static bool SaveCellValid(int x, int y) {
+    return x >= 0 && x < GRID_SIZE && y >= 0 && y < GRID_SIZE;
+}
+
+// Um save adulterado pode trazer posies, peas ou donos fora dos limites,
+// que depois indexariam o grid e o ndice espacial alm dos vetores
+static bool SaveStateValid(const GameState *game) {
+    if (game->player_count < 1 || game->player_count > MAX_PLAYERS ||
+        game->enemy_count < 0 || game->enemy_count > MAX_ENEMIES ||
+        game->bomb_count < 0 || game->bomb_count > MAX_BOMBS ||
+        game->explosion_count < 0 || game->explosion_count > MAX_EXPLOSIONS) {
+        return false;
+    }
+
+    for (int i = 0; i < game->player_count; i++) {
+        if (!SaveCellValid(game->players[i].x, game->players[i].y)) return false;
+    }
+    for (int i = 0; i < game->enemy_count; i++) {
+        if (!SaveCellValid(game->enemies[i].x, game->enemies[i].y)) return false;
+    }
+    for (int i = 0; i < game->bomb_count; i++) {
+        const Bomb *bomb = &game->bombs[i];
+        if (!SaveCellValid(bomb->x, bomb->y)) return false;
+        if (bomb->owner < -1 || bomb->owner >= game->player_count) return false;
+    }
+    for (int i = 0; i < game->explosion_count; i++) {
+        if (!SaveCellValid(game->explosions[i].x, game->explosions[i].y)) return false;
+    }
+
+    for (int y = 0; y < GRID_SIZE; y++) {
+        for (int x = 0; x < GRID_SIZE; x++) {
+            if ((unsigned int)game->grid[y][x] > RANGE_POWERUP ||
+                (unsigned int)game->hiddenGrid[y][x] > RANGE_POWERUP) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
 bool LoadGame(GameState *game) {
     FILE *file = fopen("save.bin", "rb");
     if (!file) return false;
 
-    fread(game, sizeof(GameState), 1, file);
+    SaveHeader header;
+    GameState *loaded = malloc(sizeof(GameState));
+    bool ok = loaded && fread(&header, sizeof(SaveHeader), 1, file) == 1 &&
+              header.magic == SAVE_MAGIC && header.version == SAVE_VERSION &&
+              header.size == sizeof(GameState) && fread(loaded, sizeof(GameState), 1, file) == 1;
     fclose(file);
+
+    if (!ok || !SaveStateValid(loaded)) {
+        free(loaded);
+        return false;
+    }
+
+    DifficultyValidate(&loaded->difficulty);
+
+    // Telemetria e texturas so da sesso atual, no do save
+    loaded->telemetry = game->telemetry;
+    memcpy(loaded->textures, game->textures, sizeof(game->textures));
+    *game = *loaded;
+    free(loaded);
+    RebuildSpatialIndex(game);
     return true;
 }
 
 void ResetGame(GameState *game) {
+    Telemetry *telemetry = game->telemetry;
+    DifficultyConfig difficulty = game->difficulty;
     memset(game, 0, sizeof(GameState));
+    game->telemetry = telemetry;
+    game->difficulty = difficulty.configured ? difficulty : DEFAULT_DIFFICULTY;
+}
+
+// ---------------------------------------------------------------------------
+// Replicao de estado: snapshots por tick codificados como delta em relao
+// ao ltimo tick confirmado (ack) por cada cliente.
+//
+// Formato do pacote:
+//   u8     sees presentes (NET_SECTION_*)
+//   varint tick
+//   varint tick - baseline (0 = sem baseline, pacote completo)
+//   sees, na ordem dos bits
+// ---------------------------------------------------------------------------
+
+#define NET_SECTION_GRID    0x01
+#define NET_SECTION_FIRE    0x02
+#define NET_SECTION_BOMBS   0x04
+#define NET_SECTION_PLAYER  0x08
+#define NET_SECTION_ENEMIES 0x10
+#define NET_SECTION_META    0x20
+
+typedef struct {
+    unsigned char *data;
+    int capacity;
+    int length;
+    bool overflow;
+} NetWriter;
+
+typedef struct {
+    const unsigned char *data;
+    int length;
+    int position;
+    bool error;
+} NetReader;
+
+static void NetWriteByte(NetWriter *w, unsigned int value) {
+    if (w->length >= w->capacity) {
+        w->overflow = true;
+        return;
+    }
+    w->data[w->length++] = (unsigned char)value;
+}
+
+static void NetWriteVarint(NetWriter *w, unsigned int value) {
+    while (value >= 0x80) {
+        NetWriteByte(w, (value & 0x7F) | 0x80);
+        value >>= 7;
+    }
+    NetWriteByte(w, value);
+}
+
+static unsigned int NetReadByte(NetReader *r) {
+    if (r->position >= r->length) {
+        r->error = true;
+        return 0;
+    }
+    return r->data[r->position++];
+}
+
+static unsigned int NetReadVarint(NetReader *r) {
+    unsigned int value = 0;
+    for (int shift = 0; shift < 32; shift += 7) {
+        unsigned int b = NetReadByte(r);
+        value |= (b & 0x7F) << shift;
+        if (!(b & 0x80)) return value;
+    }
+    r->error = true;
+    return 0;
+}
+
+// Baseline vazio: tudo o que existir no snapshot atual conta como mudana
+static void NetEmptySnapshot(NetSnapshot *snap) {
+    memset(snap, 0, sizeof(NetSnapshot));
+    for (int i = 0; i < MAX_PLAYERS; i++) {
+        snap->player_pos[i] = -1;
+    }
+    for (int i = 0; i < MAX_ENEMIES; i++) {
+        snap->enemy_pos[i] = -1;
+    }
+}
+
+// Plano de clulas: lista de mudanas (ndice relativo + valor) ou o plano
+// inteiro empacotado, o que for menor. Planos de 1 bit s enviam as posies
+// que mudaram, pois o valor novo  o inverso do baseline.
+static void NetWritePlane(NetWriter *w, const unsigned char *base, const unsigned char *cur, int bits) {
+    int changes = 0;
+    for (int i = 0; i < NET_CELLS; i++) {
+        if (base[i] != cur[i]) changes++;
+    }
+
+    int listBytes = changes * (bits == 1 ? 1 : 2);
+    int packedBytes = (bits == 1) ? (NET_CELLS + 7) / 8 : (NET_CELLS + 1) / 2;
+
+    if (listBytes <= packedBytes) {
+        NetWriteVarint(w, (unsigned int)changes << 1);
+        int last = -1;
+        for (int i = 0; i < NET_CELLS; i++) {
+            if (base[i] != cur[i]) {
+                NetWriteVarint(w, i - last - 1);
+                if (bits > 1) NetWriteByte(w, cur[i]);
+                last = i;
+            }
+        }
+    } else {
+        NetWriteVarint(w, 1);
+        if (bits == 1) {
+            for (int i = 0; i < NET_CELLS; i += 8) {
+                unsigned int packed = 0;
+                for (int b = 0; b < 8 && i + b < NET_CELLS; b++) {
+                    packed |= (cur[i + b] ? 1u : 0u) << b;
+                }
+                NetWriteByte(w, packed);
+            }
+        } else {
+            for (int i = 0; i < NET_CELLS; i += 2) {
+                unsigned int packed = cur[i] & 0x0F;
+                if (i + 1 < NET_CELLS) packed |= (cur[i + 1] & 0x0F) << 4;
+                NetWriteByte(w, packed);
+            }
+        }
+    }
+}
+
+// Valores acima de maxValue (ex: TileType invlido) descartam o pacote
+static void NetReadPlane(NetReader *r, unsigned char *plane, int bits, unsigned int maxValue) {
+    unsigned int header = NetReadVarint(r);
+
+    if (header & 1) {
+        if (bits == 1) {
+            for (int i = 0; i < NET_CELLS; i += 8) {
+                unsigned int packed = NetReadByte(r);
+                for (int b = 0; b < 8 && i + b < NET_CELLS; b++) {
+                    plane[i + b] = (packed >> b) & 1;
+                }
+            }
+        } else {
+            for (int i = 0; i < NET_CELLS; i += 2) {
+                unsigned int packed = NetReadByte(r);
+                if ((packed & 0x0F) > maxValue || (i + 1 < NET_CELLS && (packed >> 4) > maxValue)) {
+                    r->error = true;
+                    return;
+                }
+                plane[i] = packed & 0x0F;
+                if (i + 1 < NET_CELLS) plane[i + 1] = (packed >> 4) & 0x0F;
+            }
+        }
+        return;
+    }
+
+    unsigned int changes = header >> 1;
+    int index = -1;
+    for (unsigned int c = 0; c < changes && !r->error; c++) {
+        unsigned int skip = NetReadVarint(r);
+        if (skip >= (unsigned int)(NET_CELLS - index - 1)) {
+            r->error = true;
+            return;
+        }
+        index += (int)skip + 1;
+        if (bits > 1) {
+            unsigned int value = NetReadByte(r);
+            if (value > maxValue) {
+                r->error = true;
+                return;
+            }
+            plane[index] = (unsigned char)value;
+        } else {
+            plane[index] = !plane[index];
+        }
+    }
+}
+
+void NetCaptureSnapshot(const GameState *game, NetSnapshot *snap) {
+    memset(snap, 0, sizeof(NetSnapshot));
+
+    for (int y = 0; y < GRID_SIZE; y++) {
+        for (int x = 0; x < GRID_SIZE; x++) {
+            snap->grid[y * GRID_SIZE + x] = (unsigned char)game->grid[y][x];
+        }
+    }
+
+    for (int i = 0; i < game->explosion_count; i++) {
+        snap->fire[game->explosions[i].y * GRID_SIZE + game->explosions[i].x] = 1;
+    }
+
+    for (int i = 0; i < game->bomb_count; i++) {
+        if (!game->bombs[i].exploded) {
+            snap->bombs[game->bombs[i].y * GRID_SIZE + game->bombs[i].x] = 1;
+        }
+    }
+
+    snap->player_count = game->player_count;
+    for (int i = 0; i < MAX_PLAYERS; i++) {
+        if (i < game->player_count) {
+            const Player *player = &game->players[i];
+            snap->player_pos[i] = player->y * GRID_SIZE + player->x;
+            snap->player_flags[i] = (player->alive ? 1 : 0) | ((player->direction & 3) << 1) | (player->is_bot ? 8 : 0);
+            snap->max_bombs[i] = (unsigned char)player->max_bombs;
+            snap->bomb_range[i] = (unsigned char)player->bomb_range;
+            snap->bomb_count[i] = (unsigned char)player->bomb_count;
+            snap->player_score[i] = player->score;
+        } else {
+            snap->player_pos[i] = -1;
+        }
+    }
+
+    snap->enemy_count = game->enemy_count;
+    for (int i = 0; i < MAX_ENEMIES; i++) {
+        if (i < game->enemy_count && game->enemies[i].alive) {
+            snap->enemy_pos[i] = game->enemies[i].y * GRID_SIZE + game->enemies[i].x;
+        } else {
+            snap->enemy_pos[i] = -1;
+        }
+    }
+
+    snap->level = game->level;
+    snap->score = game->score;
+    snap->state_flags = (game->game_over ? 1 : 0) | (game->level_complete ? 2 : 0);
+}
+
+// Salta direto para a posio do grid se a diferena for maior que um passo
+static void NetSnapReal(float *real, int target) {
+    if (fabsf(*real - (float)target) > 1.0f) {
+        *real = (float)target;
+    }
+}
+
+void NetApplySnapshot(const NetSnapshot *snap, GameState *game) {
+    for (int y = 0; y < GRID_SIZE; y++) {
+        for (int x = 0; x < GRID_SIZE; x++) {
+            game->grid[y][x] = (TileType)snap->grid[y * GRID_SIZE + x];
+        }
+    }
+
+    // Bombas e exploses so reconstrudas a partir dos planos de clulas
+    game->explosion_count = 0;
+    game->bomb_count = 0;
+    for (int i = 0; i < NET_CELLS; i++) {
+        if (snap->fire[i] && game->explosion_count < MAX_EXPLOSIONS) {
+            Explosion *e = &game->explosions[game->explosion_count++];
+            e->x = i % GRID_SIZE;
+            e->y = i / GRID_SIZE;
+            e->timer = 1;
+        }
+        if (snap->bombs[i] && game->bomb_count < MAX_BOMBS) {
+            Bomb *b = &game->bombs[game->bomb_count++];
+            b->x = i % GRID_SIZE;
+            b->y = i / GRID_SIZE;
+            b->timer = 1;
+            b->range = 0;
+            b->owner = -1;
+            b->exploded = false;
+        }
+    }
+
+    game->player_count = snap->player_count;
+    for (int i = 0; i < snap->player_count; i++) {
+        Player *player = &game->players[i];
+        player->x = snap->player_pos[i] % GRID_SIZE;
+        player->y = snap->player_pos[i] / GRID_SIZE;
+        player->alive = snap->player_flags[i] & 1;
+        player->direction = (snap->player_flags[i] >> 1) & 3;
+        player->is_bot = (snap->player_flags[i] >> 3) & 1;
+        player->max_bombs = snap->max_bombs[i];
+        player->bomb_range = snap->bomb_range[i];
+        player->bomb_count = snap->bomb_count[i];
+        player->score = snap->player_score[i];
+        NetSnapReal(&player->realX, player->x);
+        NetSnapReal(&player->realY, player->y);
+    }
+
+    game->enemy_count = snap->enemy_count;
+    for (int i = 0; i < snap->enemy_count; i++) {
+        Enemy *enemy = &game->enemies[i];
+        if (snap->enemy_pos[i] >= 0) {
+            enemy->x = snap->enemy_pos[i] % GRID_SIZE;
+            enemy->y = snap->enemy_pos[i] / GRID_SIZE;
+            if (!enemy->alive) {
+                enemy->realX = (float)enemy->x;
+                enemy->realY = (float)enemy->y;
+            }
+            enemy->alive = true;
+            NetSnapReal(&enemy->realX, enemy->x);
+            NetSnapReal(&enemy->realY, enemy->y);
+        } else {
+            enemy->alive = false;
+        }
+    }
+
+    game->level = snap->level;
+    game->score = snap->score;
+    game->game_over = snap->state_flags & 1;
+    game->level_complete = (snap->state_flags >> 1) & 1;
+    RebuildSpatialIndex(game);
+}
+
+static bool NetPlayerChanged(const NetSnapshot *base, const NetSnapshot *cur, int i) {
+    return cur->player_pos[i] != base->player_pos[i] || cur->player_flags[i] != base->player_flags[i] ||
+           cur->max_bombs[i] != base->max_bombs[i] || cur->bomb_range[i] != base->bomb_range[i] ||
+           cur->bomb_count[i] != base->bomb_count[i] ||
+           cur->player_score[i] != base->player_score[i];
+}
+
+void NetServerInit(NetServer *server) {
+    memset(server, 0, sizeof(NetServer));
+}
+
+void NetServerCapture(NetServer *server, const GameState *game) {
+    server->tick++;
+    NetSnapshot *snap = &server->history[server->tick % NET_HISTORY];
+    NetCaptureSnapshot(game, snap);
+    snap->tick = server->tick;
+}
+
+// Codifica o tick atual do servidor em relao ao baseline confirmado pelo
+// cliente. Se o baseline j saiu do histrico, envia o estado completo.
+// Retorna o tamanho do pacote ou -1 se no couber no buffer.
+int NetEncodeDelta(const NetServer *server, const NetPeer *peer, unsigned char *buffer, int capacity) {
+    const NetSnapshot *cur = &server->history[server->tick % NET_HISTORY];
+    const NetSnapshot *base = NULL;
+    NetSnapshot empty;
+
+    if (peer->acked_tick != 0 &&
+        server->tick - peer->acked_tick < NET_HISTORY &&
+        server->history[peer->acked_tick % NET_HISTORY].tick == peer->acked_tick) {
+        base = &server->history[peer->acked_tick % NET_HISTORY];
+    } else {
+        NetEmptySnapshot(&empty);
+        base = &empty;
+    }
+
+    bool playersChanged = cur->player_count != base->player_count;
+    for (int i = 0; i < cur->player_count && !playersChanged; i++) {
+        if (NetPlayerChanged(base, cur, i)) playersChanged = true;
+    }
+
+    bool enemiesChanged = cur->enemy_count != base->enemy_count;
+    for (int i = 0; i < cur->enemy_count && !enemiesChanged; i++) {
+        if (cur->enemy_pos[i] != base->enemy_pos[i]) enemiesChanged = true;
+    }
+
+    unsigned int sections = 0;
+    if (memcmp(cur->grid, base->grid, NET_CELLS) != 0) sections |= NET_SECTION_GRID;
+    if (memcmp(cur->fire, base->fire, NET_CELLS) != 0) sections |= NET_SECTION_FIRE;
+    if (memcmp(cur->bombs, base->bombs, NET_CELLS) != 0) sections |= NET_SECTION_BOMBS;
+    if (playersChanged) sections |= NET_SECTION_PLAYER;
+    if (enemiesChanged) sections |= NET_SECTION_ENEMIES;
+    if (cur->level != base->level || cur->score != base->score ||
+        cur->state_flags != base->state_flags) {
+        sections |= NET_SECTION_META;
+    }
+
+    NetWriter w = { buffer, capacity, 0, false };
+    NetWriteByte(&w, sections);
+    NetWriteVarint(&w, cur->tick);
+    NetWriteVarint(&w, base == &empty ? 0 : cur->tick - base->tick);
+
+    if (sections & NET_SECTION_GRID) NetWritePlane(&w, base->grid, cur->grid, 3);
+    if (sections & NET_SECTION_FIRE) NetWritePlane(&w, base->fire, cur->fire, 1);
+    if (sections & NET_SECTION_BOMBS) NetWritePlane(&w, base->bombs, cur->bombs, 1);
+
+    if (sections & NET_SECTION_PLAYER) {
+        int changes = 0;
+        for (int i = 0; i < cur->player_count; i++) {
+            if (NetPlayerChanged(base, cur, i)) changes++;
+        }
+        NetWriteVarint(&w, cur->player_count);
+        NetWriteVarint(&w, changes);
+        int last = -1;
+        for (int i = 0; i < cur->player_count; i++) {
+            if (NetPlayerChanged(base, cur, i)) {
+                NetWriteVarint(&w, i - last - 1);
+                NetWriteVarint(&w, cur->player_pos[i]);
+                NetWriteByte(&w, cur->player_flags[i]);
+                NetWriteByte(&w, cur->max_bombs[i]);
+                NetWriteByte(&w, cur->bomb_range[i]);
+                NetWriteByte(&w, cur->bomb_count[i]);
+                NetWriteVarint(&w, cur->player_score[i]);
+                last = i;
+            }
+        }
+    }
+
+    if (sections & NET_SECTION_ENEMIES) {
+        int changes = 0;
+        for (int i = 0; i < cur->enemy_count; i++) {
+            if (cur->enemy_pos[i] != base->enemy_pos[i]) changes++;
+        }
+        NetWriteVarint(&w, cur->enemy_count);
+        NetWriteVarint(&w, changes);
+        int last = -1;
+        for (int i = 0; i < cur->enemy_count; i++) {
+            if (cur->enemy_pos[i] != base->enemy_pos[i]) {
+                NetWriteVarint(&w, i - last - 1);
+                NetWriteVarint(&w, cur->enemy_pos[i] + 1); // 0 = morto
+                last = i;
+            }
+        }
+    }
+
+    if (sections & NET_SECTION_META) {
+        NetWriteVarint(&w, cur->level);
+        NetWriteVarint(&w, cur->score);
+        NetWriteByte(&w, cur->state_flags);
+    }
+
+    return w.overflow ? -1 : w.length;
+}
+
+void NetPeerAck(NetPeer *peer, unsigned int tick) {
+    if (tick > peer->acked_tick) {
+        peer->acked_tick = tick;
+    }
+}
+
+void NetDecoderInit(NetDecoder *decoder) {
+    memset(decoder, 0, sizeof(NetDecoder));
+}
+
+// Reconstri o estado do pacote sobre o baseline indicado e aplica no jogo.
+// Pacotes antigos, corrompidos ou com baseline desconhecido so descartados;
+// nesses casos o cliente no confirma o tick e o servidor volta a usar o
+// ltimo baseline confirmado.
+bool NetDecodeDelta(NetDecoder *decoder, const unsigned char *buffer, int length, GameState *game, unsigned int *tick) {
+    NetReader r = { buffer, length, 0, false };
+    unsigned int sections = NetReadByte(&r);
+    unsigned int packetTick = NetReadVarint(&r);
+    unsigned int delta = NetReadVarint(&r);
+
+    if (r.error || packetTick <= decoder->last_tick) return false;
+
+    NetSnapshot snap;
+    if (delta == 0) {
+        NetEmptySnapshot(&snap);
+    } else {
+        unsigned int baseTick = packetTick - delta;
+        const NetSnapshot *base = &decoder->history[baseTick % NET_HISTORY];
+        if (delta >= NET_HISTORY || baseTick == 0 || base->tick != baseTick) return false;
+        snap = *base;
+    }
+
+    if (sections & NET_SECTION_GRID) NetReadPlane(&r, snap.grid, 3, RANGE_POWERUP);
+    if (sections & NET_SECTION_FIRE) NetReadPlane(&r, snap.fire, 1, 1);
+    if (sections & NET_SECTION_BOMBS) NetReadPlane(&r, snap.bombs, 1, 1);
+
+    if (sections & NET_SECTION_PLAYER) {
+        unsigned int count = NetReadVarint(&r);
+        unsigned int changes = NetReadVarint(&r);
+        if (count > MAX_PLAYERS) {
+            r.error = true;
+            count = 0;
+        }
+        snap.player_count = (int)count;
+        for (int i = snap.player_count; i < MAX_PLAYERS && !r.error; i++) {
+            snap.player_pos[i] = -1;
+        }
+        int index = -1;
+        for (unsigned int c = 0; c < changes && !r.error; c++) {
+            unsigned int skip = NetReadVarint(&r);
+            unsigned int pos = NetReadVarint(&r);
+            if (skip >= (unsigned int)(snap.player_count - index - 1) || pos >= NET_CELLS) {
+                r.error = true;
+                break;
+            }
+            index += (int)skip + 1;
+            snap.player_pos[index] = (int)pos;
+            snap.player_flags[index] = (unsigned char)NetReadByte(&r);
+            snap.max_bombs[index] = (unsigned char)NetReadByte(&r);
+            snap.bomb_range[index] = (unsigned char)NetReadByte(&r);
+            snap.bomb_count[index] = (unsigned char)NetReadByte(&r);
+            snap.player_score[index] = (int)NetReadVarint(&r);
+        }
+    }
+
+    if (sections & NET_SECTION_ENEMIES) {
+        // Contagem validada antes da converso para int (varints grandes viram negativos)
+        unsigned int count = NetReadVarint(&r);
+        unsigned int changes = NetReadVarint(&r);
+        if (count > MAX_ENEMIES) {
+            r.error = true;
+            count = 0;
+        }
+        snap.enemy_count = (int)count;
+        for (int i = snap.enemy_count; i < MAX_ENEMIES && !r.error; i++) {
+            snap.enemy_pos[i] = -1;
+        }
+        int index = -1;
+        for (unsigned int c = 0; c < changes && !r.error; c++) {
+            unsigned int skip = NetReadVarint(&r);
+            unsigned int pos = NetReadVarint(&r);   // Posio + 1 (0 = morto)
+            if (skip >= (unsigned int)(snap.enemy_count - index - 1) || pos > NET_CELLS) {
+                r.error = true;
+                break;
+            }
+            index += (int)skip + 1;
+            snap.enemy_pos[index] = (int)pos - 1;
+        }
+    }
+
+    if (sections & NET_SECTION_META) {
+        snap.level = (int)NetReadVarint(&r);
+        snap.score = (int)NetReadVarint(&r);
+        snap.state_flags = (unsigned char)NetReadByte(&r);
+    }
+
+    for (int i = 0; i < snap.player_count && !r.error; i++) {
+        if (snap.player_pos[i] < 0 || snap.player_pos[i] >= NET_CELLS) r.error = true;
+    }
+    if (r.error) return false;
+
+    snap.tick = packetTick;
+    decoder->history[packetTick % NET_HISTORY] = snap;
+    decoder->last_tick = packetTick;
+    NetApplySnapshot(&snap, game);
+
+    if (tick) *tick = packetTick;
+    return true;
+}
+
+// Interpolao suave das posies replicadas (equivalente  do UpdateGame)
+void SmoothReplicatedState(GameState *game, float dt) {
+    float speed = 5.0f * dt;
+    for (int i = 0; i < game->player_count; i++) {
+        game->players[i].realX += (game->players[i].x - game->players[i].realX) * speed;
+        game->players[i].realY += (game->players[i].y - game->players[i].realY) * speed;
+    }
+
+    for (int i = 0; i < game->enemy_count; i++) {
+        if (game->enemies[i].alive) {
+            game->enemies[i].realX += (game->enemies[i].x - game->enemies[i].realX) * speed;
+            game->enemies[i].realY += (game->enemies[i].y - game->enemies[i].realY) * speed;
+        }
+    }
+}
+
+double GetMonotonicTime(void) {
+#ifdef _WIN32
+    long long count, frequency;
+    QueryPerformanceCounter(&count);
+    QueryPerformanceFrequency(&frequency);
+    return (double)count / (double)frequency;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+#endif
+}
+
+// ---------------------------------------------------------------------------
+// Benchmark da replicao (./bomberman --bench-net [ticks])
+// Roda o jogo sem janela com bombas sendo plantadas o tempo todo, codifica
+// cada tick para um cliente que perde ~5% dos pacotes e confirma com atraso,
+// e confere se o estado decodificado bate com o do servidor.
+// Para mapas maiores: gcc -DGRID_SIZE=41 -DMAX_ENEMIES=64 ...
+// ---------------------------------------------------------------------------
+
+#define NET_BENCH_ACK_DELAY 6   // Ticks at o ack chegar ao servidor
+#define NET_BENCH_LOSS 5        // Porcentagem de pacotes perdidos
+
+// Mantm o mapa movimentado: revive os bots e leva um deles para uma clula
+// livre aleatria para plantar uma bomba sempre que houver espao
+static void NetBenchStir(GameState *game) {
+    for (int i = 0; i < game->player_count; i++) {
+        game->players[i].max_bombs = MAX_BOMBS_PER_PLAYER;
+        game->players[i].alive = true;
+    }
+    game->game_over = false;
+
+    int p = rand() % game->player_count;
+    int x = rand() % (GRID_SIZE-2) + 1;
+    int y = rand() % (GRID_SIZE-2) + 1;
+    if (game->grid[y][x] != INDESTRUCTIBLE && game->grid[y][x] != DESTRUCTIBLE) {
+        game->players[p].x = x;
+        game->players[p].y = y;
+        PlantBomb(game, p);
+    }
+}
+
+void RunNetBenchmark(int ticks) {
+    static GameState server_game;
+    static GameState client_game;
+    static NetServer server;
+    static NetDecoder decoder;
+    NetPeer peer = {0};
+    unsigned char packet[NET_MAX_PACKET];
+    unsigned int pendingAcks[NET_BENCH_ACK_DELAY] = {0};
+
+    if (ticks <= 0) ticks = 20000;
+
+    srand(12345);
+    memset(&server_game, 0, sizeof(GameState));
+    memset(&client_game, 0, sizeof(GameState));
+    NetServerInit(&server);
+    NetDecoderInit(&decoder);
+
+    // Nvel alto o suficiente para ter o mximo de inimigos
+    int level = MAX_ENEMIES - 2 > 1 ? MAX_ENEMIES - 2 : 1;
+    ConfigurePlayers(&server_game, 0, 4, BOT_HEURISTIC);
+    InitGame(&server_game, level);
+
+    long long totalBytes = 0;
+    long long fullBytes = 0;
+    int maxBytes = 0;
+    int attempts = 0;
+    int delivered = 0;
+    int mismatches = 0;
+    double encodeTime = 0.0;
+    double decodeTime = 0.0;
+
+    for (int t = 0; t < ticks; t++) {
+        // Recomea o nvel periodicamente para incluir ticks de troca de mapa
+        if (t > 0 && t % 1200 == 0) {
+            InitGame(&server_game, level);
+        }
+
+        NetBenchStir(&server_game);
+        UpdateGame(&server_game, NULL, NULL);
+        NetServerCapture(&server, &server_game);
+
+        // Acks que chegam neste tick
+        NetPeerAck(&peer, pendingAcks[t % NET_BENCH_ACK_DELAY]);
+        pendingAcks[t % NET_BENCH_ACK_DELAY] = 0;
+
+        double start = GetMonotonicTime();
+        int length = NetEncodeDelta(&server, &peer, packet, sizeof(packet));
+        encodeTime += GetMonotonicTime() - start;
+
+        if (length < 0) {
+            printf("Pacote excedeu %d bytes no tick %d\n", (int)sizeof(packet), t);
+            return;
+        }
+        totalBytes += length;
+        if (length > maxBytes) maxBytes = length;
+
+        // Referncia: o mesmo tick enviado sem baseline
+        NetPeer fresh = {0};
+        unsigned char fullPacket[NET_MAX_PACKET];
+        fullBytes += NetEncodeDelta(&server, &fresh, fullPacket, sizeof(fullPacket));
+
+        if (rand() % 100 < NET_BENCH_LOSS) continue;
+
+        unsigned int ackTick = 0;
+        attempts++;
+        start = GetMonotonicTime();
+        bool ok = NetDecodeDelta(&decoder, packet, length, &client_game, &ackTick);
+        decodeTime += GetMonotonicTime() - start;
+
+        if (ok) {
+            delivered++;
+            pendingAcks[t % NET_BENCH_ACK_DELAY] = ackTick;
+
+            NetSnapshot check;
+            NetCaptureSnapshot(&client_game, &check);
+            check.tick = server.tick;
+            if (memcmp(&check, &server.history[server.tick % NET_HISTORY], sizeof(NetSnapshot)) != 0) {
+                mismatches++;
+            }
+        }
+    }
+
+    printf("Replicao: grid %dx%d, %d jogadores, %d inimigos, %d ticks\n", GRID_SIZE, GRID_SIZE,
+           server_game.player_count, server_game.enemy_count, ticks);
+    printf("  bytes/tick (delta):    %.1f (mx %d)\n", (double)totalBytes / ticks, maxBytes);
+    printf("  bytes/tick (completo): %.1f\n", (double)fullBytes / ticks);
+    printf("  encode: %.0f ns/tick\n", encodeTime * 1e9 / ticks);
+    printf("  decode: %.0f ns/tick\n", attempts ? decodeTime * 1e9 / attempts : 0.0);
+    printf("  pacotes entregues: %d, estados divergentes: %d\n", delivered, mismatches);
+}
+
+// ---------------------------------------------------------------------------
+// Bot MCTS: busca em rvore Monte Carlo sobre cpias do estado do jogo.
+// Cada deciso dura BOT_THINK_TICKS frames; os playouts simulam at
+// MCTS_HORIZON decises  frente com o StepGame, com os outros jogadores
+// controlados pelo bot simples.
+// ---------------------------------------------------------------------------
+
+static unsigned int MctsRandom(unsigned int *state) {
+    unsigned int x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+static void ActionToInput(int action, PlayerInput *input) {
+    input->dx = 0;
+    input->dy = 0;
+    input->bomb = false;
+    switch (action) {
+        case ACTION_UP: input->dy = -1; break;
+        case ACTION_DOWN: input->dy = 1; break;
+        case ACTION_LEFT: input->dx = -1; break;
+        case ACTION_RIGHT: input->dx = 1; break;
+        case ACTION_BOMB: input->bomb = true; break;
+    }
+}
+
+static int MctsInputAction(const PlayerInput *input) {
+    if (input->bomb) return ACTION_BOMB;
+    if (input->dy < 0) return ACTION_UP;
+    if (input->dy > 0) return ACTION_DOWN;
+    if (input->dx < 0) return ACTION_LEFT;
+    if (input->dx > 0) return ACTION_RIGHT;
+    return ACTION_STAY;
+}
+
+// Aes que tm efeito no estado atual (bit por ao)
+static unsigned int MctsValidActions(const GameState *game, int player) {
+    const Player *p = &game->players[player];
+    unsigned int mask = 1u << ACTION_STAY;
+
+    if (IsWalkable(game, p->x, p->y - 1)) mask |= 1u << ACTION_UP;
+    if (IsWalkable(game, p->x, p->y + 1)) mask |= 1u << ACTION_DOWN;
+    if (IsWalkable(game, p->x - 1, p->y)) mask |= 1u << ACTION_LEFT;
+    if (IsWalkable(game, p->x + 1, p->y)) mask |= 1u << ACTION_RIGHT;
+    if (p->bomb_count < p->max_bombs && !game->index.bomb[p->y][p->x]) mask |= 1u << ACTION_BOMB;
+    return mask;
+}
+
+static bool MctsTerminal(const GameState *game, int player) {
+    return game->game_over || game->level_complete || !game->players[player].alive;
+}
+
+// Simula uma deciso: a ao no primeiro frame e nada nos seguintes.
+// Retorna quantos frames foram simulados.
+static int SimulateDecision(GameState *game, int player, int action) {
+    PlayerInput inputs[MAX_PLAYERS];
+    int t;
+
+    for (t = 0; t < BOT_THINK_TICKS && !MctsTerminal(game, player); t++) {
+        for (int i = 0; i < game->player_count; i++) {
+            memset(&inputs[i], 0, sizeof(PlayerInput));
+            if (i == player) {
+                if (t == 0) ActionToInput(action, &inputs[i]);
+            }
+            else if (game->players[i].alive && ++game->players[i].bot_timer >= BOT_THINK_TICKS) {
+                game->players[i].bot_timer = 0;
+                BotInput(game, i, &inputs[i]);
+            }
+        }
+        StepGame(game, inputs, 0.0f);
+    }
+    return t;
+}
+
+static int MctsCountWalls(const GameState *game) {
+    int walls = 0;
+    for (int y = 0; y < GRID_SIZE; y++) {
+        for (int x = 0; x < GRID_SIZE; x++) {
+            if (game->grid[y][x] == DESTRUCTIBLE) walls++;
+        }
+    }
+    return walls;
+}
+
+// Avaliao do fim do playout em [0, 1]: morrer vale 0; pontos, paredes
+// destrudas, power-ups e completar a fase aumentam o valor. Bombas ainda
+// armadas contam parcialmente pelo que vo atingir.
+static float MctsEvaluate(const GameState *root, int rootWalls, GameState *game, int player) {
+    const Player *p = &game->players[player];
+    const Player *start = &root->players[player];
+    if (!p->alive) return 0.0f;
+
+    bool danger[GRID_SIZE][GRID_SIZE];
+    BuildDangerMap(game, danger);
+
+    int threatenedWalls = 0;
+    int threatenedEnemies = 0;
+    for (int y = 0; y < GRID_SIZE; y++) {
+        for (int x = 0; x < GRID_SIZE; x++) {
+            if (!danger[y][x]) continue;
+            if (game->grid[y][x] == DESTRUCTIBLE) threatenedWalls++;
+            if (game->index.enemy[y][x] >= 0) threatenedEnemies++;
+        }
+    }
+
+    float value = 0.4f;
+    value += 0.12f * (p->score - start->score) / 100.0f;
+    value += 0.02f * (rootWalls - MctsCountWalls(game));
+    value += 0.01f * threatenedWalls + 0.03f * threatenedEnemies;
+    value += 0.08f * ((p->max_bombs - start->max_bombs) + (p->bomb_range - start->bomb_range));
+    if (game->level_complete) value += 0.5f;
+
+    // Sem inimigos vivos, aproximar-se da sada revelada tambm conta
+    bool enemiesLeft = false;
+    for (int i = 0; i < game->enemy_count; i++) {
+        if (game->enemies[i].alive) {
+            enemiesLeft = true;
+            break;
+        }
+    }
+    if (!enemiesLeft && !game->level_complete) {
+        for (int y = 0; y < GRID_SIZE; y++) {
+            for (int x = 0; x < GRID_SIZE; x++) {
+                if (game->grid[y][x] == EXIT) {
+                    int dist = abs(x - p->x) + abs(y - p->y);
+                    value += 0.2f * (1.0f - (float)dist / (2 * GRID_SIZE));
+                }
+            }
+        }
+    }
+
+    // Parado na rea de uma exploso sem sada prxima: provavelmente morto
+    int stepX, stepY;
+    if (danger[p->y][p->x] && !FindSafeStep(game, danger, p->x, p->y, 3, &stepX, &stepY)) {
+        value *= 0.2f;
+    }
+
+    if (value > 1.0f) value = 1.0f;
+    return value;
+}
+
+static int MctsNewNode(MctsWorker *worker) {
+    if (worker->node_count >= MCTS_MAX_NODES) return -1;
+    MctsNode *node = &worker->nodes[worker->node_count];
+    for (int a = 0; a < NUM_ACTIONS; a++) {
+        node->children[a] = -1;
+    }
+    node->visits = 0;
+    node->value = 0.0f;
+    return worker->node_count++;
+}
+
+// Um playout: seleo por UCT, expanso de um n, rollout e retropropagao
+static void MctsPlayout(MctsWorker *worker, const GameState *root, int rootWalls, int player) {
+    GameState state = *root;
+    int path[MCTS_HORIZON + 1];
+    int length = 0;
+    int node = 0;
+    int depth = 0;
+
+    state.rng = MctsRandom(&worker->rng) | 1;
+    path[length++] = node;
+
+    // Seleo e expanso
+    while (depth < MCTS_HORIZON && !MctsTerminal(&state, player)) {
+        unsigned int valid = MctsValidActions(&state, player);
+        int unexpanded[NUM_ACTIONS];
+        int unexpandedCount = 0;
+
+        for (int a = 0; a < NUM_ACTIONS; a++) {
+            if ((valid & (1u << a)) && worker->nodes[node].children[a] < 0) {
+                unexpanded[unexpandedCount++] = a;
+            }
+        }
+
+        int action = -1;
+        bool expanded = false;
+        if (unexpandedCount > 0) {
+            int a = unexpanded[MctsRandom(&worker->rng) % unexpandedCount];
+            int child = MctsNewNode(worker);
+            if (child >= 0) {
+                worker->nodes[node].children[a] = child;
+                action = a;
+                expanded = true;
+            }
+        }
+
+        if (action < 0) {
+            // UCT entre os filhos j expandidos e vlidos neste estado
+            float best = -1.0f;
+            float logParent = logf((float)worker->nodes[node].visits + 1.0f);
+            for (int a = 0; a < NUM_ACTIONS; a++) {
+                int child = worker->nodes[node].children[a];
+                if (!(valid & (1u << a)) || child < 0) continue;
+                const MctsNode *c = &worker->nodes[child];
+                float score = (c->visits > 0)
+                    ? c->value / c->visits + 1.4f * sqrtf(logParent / c->visits)
+                    : 1e9f;
+                if (score > best) {
+                    best = score;
+                    action = a;
+                }
+            }
+        }
+        if (action < 0) break;
+
+        worker->frames += SimulateDecision(&state, player, action);
+        node = worker->nodes[node].children[action];
+        path[length++] = node;
+        depth++;
+
+        if (expanded) break;
+    }
+
+    // Rollout: metade das decises pelo bot simples, metade aleatrias
+    while (depth < MCTS_HORIZON && !MctsTerminal(&state, player)) {
+        int action;
+        if (MctsRandom(&worker->rng) & 1) {
+            PlayerInput input;
+            BotInput(&state, player, &input);
+            action = MctsInputAction(&input);
+        } else {
+            unsigned int valid = MctsValidActions(&state, player);
+            do {
+                action = MctsRandom(&worker->rng) % NUM_ACTIONS;
+            } while (!(valid & (1u << action)));
+        }
+        worker->frames += SimulateDecision(&state, player, action);
+        depth++;
+    }
+
+    float value = MctsEvaluate(root, rootWalls, &state, player);
+    for (int i = 0; i < length; i++) {
+        worker->nodes[path[i]].visits++;
+        worker->nodes[path[i]].value += value;
+    }
+    worker->playouts++;
+}
+
+static void MctsRun(MctsWorker *worker) {
+    MctsSearch *search = worker->search;
+    int rootWalls = MctsCountWalls(&search->root);
+
+    worker->node_count = 0;
+    worker->playouts = 0;
+    worker->frames = 0;
+    MctsNewNode(worker);
+
+    do {
+        MctsPlayout(worker, &search->root, rootWalls, search->player);
+    } while (GetMonotonicTime() < search->deadline);
+
+    for (int a = 0; a < NUM_ACTIONS; a++) {
+        int child = worker->nodes[0].children[a];
+        worker->visits[a] = child >= 0 ? worker->nodes[child].visits : 0;
+        worker->value[a] = child >= 0 ? worker->nodes[child].value : 0.0f;
+    }
+}
+
+// Cada ndice  uma rvore independente
+static void MctsRunRange(void *context, int begin, int end) {
+    MctsSearch *search = (MctsSearch *)context;
+    for (int i = begin; i < end; i++) {
+        MctsRun(&search->workers[i]);
+    }
+}
+
+// threads <= 0 usa um por ncleo, contando a thread que pede a deciso
+void MctsInit(MctsSearch *search, int threads) {
+    memset(search, 0, sizeof(MctsSearch));
+    threads = ResolveThreadCount(threads, MCTS_MAX_THREADS);
+
+    for (int i = 0; i < threads; i++) {
+        MctsWorker *worker = &search->workers[i];
+        worker->search = search;
+        worker->rng = 0x2545F491u * (unsigned int)(i + 1);
+        worker->nodes = malloc(sizeof(MctsNode) * MCTS_MAX_NODES);
+        if (!worker->nodes) break;
+        search->thread_count++;
+    }
+    if (search->thread_count > 0) {
+        WorkerPoolInit(&search->pool, search->thread_count);
+    }
+}
+
+void MctsShutdown(MctsSearch *search) {
+    if (search->thread_count == 0) return;
+
+    WorkerPoolShutdown(&search->pool);
+    for (int i = 0; i < search->thread_count; i++) {
+        free(search->workers[i].nodes);
+        search->workers[i].nodes = NULL;
+    }
+    search->thread_count = 0;
+}
+
+// Escolhe a entrada do jogador dentro do oramento de tempo (em segundos)
+void MctsChooseInput(MctsSearch *search, const GameState *game, int player, double budget, PlayerInput *input) {
+    if (search->thread_count == 0) {
+        GameState copy = *game;
+        copy.telemetry = NULL;
+        BotInput(&copy, player, input);
+        return;
+    }
+
+    double start = GetMonotonicTime();
+
+    search->root = *game;
+    search->root.telemetry = NULL; // Playouts no geram eventos
+    search->player = player;
+    search->deadline = start + budget;
+    WorkerPoolFor(&search->pool, search->thread_count, 1, MctsRunRange, search);
+
+    // Soma as visitas da raiz de todas as threads e escolhe a mais visitada
+    int visits[NUM_ACTIONS] = {0};
+    float value[NUM_ACTIONS] = {0};
+    long long playouts = 0;
+    long long frames = 0;
+    for (int i = 0; i < search->thread_count; i++) {
+        for (int a = 0; a < NUM_ACTIONS; a++) {
+            visits[a] += search->workers[i].visits[a];
+            value[a] += search->workers[i].value[a];
+        }
+        playouts += search->workers[i].playouts;
+        frames += search->workers[i].frames;
+    }
+
+    int best = ACTION_STAY;
+    for (int a = 0; a < NUM_ACTIONS; a++) {
+        if (visits[a] > visits[best] ||
+            (visits[a] == visits[best] && visits[a] > 0 && value[a] / visits[a] > value[best] / visits[best])) {
+            best = a;
+        }
+    }
+    ActionToInput(best, input);
+
+    search->last_playouts = playouts;
+    search->total_playouts += playouts;
+    search->total_frames += frames;
+    search->total_seconds += GetMonotonicTime() - start;
+    search->decisions++;
+}
+
+// ---------------------------------------------------------------------------
+// Benchmark do bot MCTS (./bomberman --bench-mcts [ms por deciso] [threads] [ticks])
+// Um nico bot MCTS joga sozinho at morrer ou acabar o tempo.
+// ---------------------------------------------------------------------------
+
+void RunMctsBenchmark(double budgetMs, int threads, int maxTicks) {
+    static GameState game;
+    static MctsSearch search;
+    PlayerInput inputs[MAX_PLAYERS];
+
+    if (budgetMs <= 0.0) budgetMs = MCTS_BUDGET * 1000.0;
+
+    srand(4242);
+    memset(&game, 0, sizeof(GameState));
+    ConfigurePlayers(&game, 0, 1, BOT_MCTS);
+    InitGame(&game, 1);
+    MctsInit(&search, threads);
+
+    int tick = 0;
+    int levels = 0;
+    while (tick < maxTicks && !game.game_over) {
+        memset(inputs, 0, sizeof(inputs));
+        if (++game.players[0].bot_timer >= BOT_THINK_TICKS) {
+            game.players[0].bot_timer = 0;
+            MctsChooseInput(&search, &game, 0, budgetMs / 1000.0, &inputs[0]);
+        }
+        StepGame(&game, inputs, 1.0f / 60.0f);
+        tick++;
+
+        if (game.level_complete) {
+            levels++;
+            InitGame(&game, game.level + 1);
+        }
+    }
+
+    printf("MCTS: %d threads, %.2f ms por deciso, %d decises\n", search.thread_count, budgetMs, search.decisions);
+    if (search.decisions > 0) {
+        printf("  playouts/deciso: %.0f\n", (double)search.total_playouts / search.decisions);
+        printf("  playouts/s:       %.0f\n", search.total_playouts / search.total_seconds);
+        printf("  frames simulados/s: %.0f\n", search.total_frames / search.total_seconds);
+    }
+    printf("  resultado: %d fases completas, score %d, %s aps %d frames\n", levels, game.score,
+           game.game_over ? "morreu" : "vivo", tick);
+
+    MctsShutdown(&search);
+}
+
+// ---------------------------------------------------------------------------
+// Telemetria
+// ---------------------------------------------------------------------------
+
+static const char *EVENT_NAMES[NUM_EVENT_TYPES] = {
+    "level_start", "bomb_planted", "enemy_killed", "score",
+    "powerup", "player_death", "level_complete", "game_over"
+};
+
+static const char *DEATH_CAUSE_NAMES[NUM_DEATH_CAUSES] = {
+    "explosion", "enemy"
+};
+
+// Produtor (thread da simulao): nunca bloqueia. Com a fila cheia o evento
+//  descartado e contado em dropped.
+void TelemetryPublish(Telemetry *telemetry, const TelemetryEvent *event) {
+    unsigned int tail = atomic_load_explicit(&telemetry->tail, memory_order_relaxed);
+    unsigned int head = atomic_load_explicit(&telemetry->head, memory_order_acquire);
+
+    if (tail - head >= TELEMETRY_RING_SIZE) {
+        atomic_fetch_add_explicit(&telemetry->dropped, 1, memory_order_relaxed);
+        return;
+    }
+
+    memcpy(&telemetry->events[tail & (TELEMETRY_RING_SIZE - 1)], event, sizeof(TelemetryEvent));
+    atomic_store_explicit(&telemetry->tail, tail + 1, memory_order_release);
+}
+
+static void TelemetryWriteEvent(Telemetry *telemetry, const TelemetryEvent *event) {
+    if (event->type >= NUM_EVENT_TYPES) return;
+
+    // Agregados para o arquivo de mtricas
+    telemetry->counts[event->type]++;
+    telemetry->last_tick = event->tick;
+    switch (event->type) {
+        case EVENT_SCORE:
+            telemetry->score_total += event->value;
+            if (event->player >= 0 && event->player < MAX_PLAYERS) {
+                telemetry->player_score[event->player] += event->value;
+            }
+            break;
+        case EVENT_PLAYER_DEATH:
+            if (event->value >= 0 && event->value < NUM_DEATH_CAUSES) {
+                telemetry->deaths[event->value]++;
+            }
+            break;
+        case EVENT_LEVEL_START:
+            telemetry->level = event->value;
+            break;
+    }
+
+    if (!telemetry->log) return;
+    if (telemetry->binary) {
+        fwrite(event, sizeof(TelemetryEvent), 1, telemetry->log);
+    } else {
+        fprintf(telemetry->log,
+                "{\"t\":%.3f,\"tick\":%u,\"type\":\"%s\",\"player\":%d,\"x\":%d,\"y\":%d,\"value\":%d,\"other\":%d}\n",
+                event->time - telemetry->start_time, event->tick, EVENT_NAMES[event->type],
+                event->player, event->x, event->y, event->value, event->other);
+    }
+    telemetry->written++;
+}
+
+// Reescreve o arquivo de mtricas no formato texto do Prometheus. Escreve
+// num arquivo temporrio e renomeia para o leitor nunca ver um arquivo pela metade.
+static void TelemetryWriteMetrics(Telemetry *telemetry) {
+    if (telemetry->metrics_path[0] == '\0') return;
+
+    char tmpPath[272];
+    snprintf(tmpPath, sizeof(tmpPath), "%s.tmp", telemetry->metrics_path);
+    FILE *file = fopen(tmpPath, "w");
+    if (!file) return;
+
+    fprintf(file, "# HELP bomberman_events_total Gameplay events by type.\n");
+    fprintf(file, "# TYPE bomberman_events_total counter\n");
+    for (int i = 0; i < NUM_EVENT_TYPES; i++) {
+        fprintf(file, "bomberman_events_total{type=\"%s\"} %lld\n", EVENT_NAMES[i], telemetry->counts[i]);
+    }
+
+    fprintf(file, "# HELP bomberman_player_deaths_total Player deaths by cause.\n");
+    fprintf(file, "# TYPE bomberman_player_deaths_total counter\n");
+    for (int i = 0; i < NUM_DEATH_CAUSES; i++) {
+        fprintf(file, "bomberman_player_deaths_total{cause=\"%s\"} %lld\n", DEATH_CAUSE_NAMES[i], telemetry->deaths[i]);
+    }
+
+    fprintf(file, "# HELP bomberman_score_total Points scored by all players.\n");
+    fprintf(file, "# TYPE bomberman_score_total counter\n");
+    fprintf(file, "bomberman_score_total %lld\n", telemetry->score_total);
+
+    fprintf(file, "# HELP bomberman_player_score_total Points scored by each player.\n");
+    fprintf(file, "# TYPE bomberman_player_score_total counter\n");
+    for (int i = 0; i < MAX_PLAYERS; i++) {
+        fprintf(file, "bomberman_player_score_total{player=\"%d\"} %lld\n", i + 1, telemetry->player_score[i]);
+    }
+
+    fprintf(file, "# HELP bomberman_level Current level.\n");
+    fprintf(file, "# TYPE bomberman_level gauge\n");
+    fprintf(file, "bomberman_level %d\n", telemetry->level);
+
+    fprintf(file, "# HELP bomberman_tick Last simulation tick seen by the writer.\n");
+    fprintf(file, "# TYPE bomberman_tick gauge\n");
+    fprintf(file, "bomberman_tick %u\n", telemetry->last_tick);
+
+    fprintf(file, "# HELP bomberman_telemetry_dropped_total Events dropped because the ring was full.\n");
+    fprintf(file, "# TYPE bomberman_telemetry_dropped_total counter\n");
+    fprintf(file, "bomberman_telemetry_dropped_total %u\n",
+            atomic_load_explicit(&telemetry->dropped, memory_order_relaxed));
+
+    fclose(file);
+    rename(tmpPath, telemetry->metrics_path);
+}
+
+// Consumidor: esvazia a fila e devolve quantos eventos foram gravados
+static int TelemetryDrain(Telemetry *telemetry) {
+    unsigned int head = atomic_load_explicit(&telemetry->head, memory_order_relaxed);
+    unsigned int tail = atomic_load_explicit(&telemetry->tail, memory_order_acquire);
+    int count = 0;
+
+    while (head != tail) {
+        TelemetryWriteEvent(telemetry, &telemetry->events[head & (TELEMETRY_RING_SIZE - 1)]);
+        head++;
+        count++;
+    }
+    atomic_store_explicit(&telemetry->head, head, memory_order_release);
+    return count;
+}
+
+static void *TelemetryWriterMain(void *arg) {
+    Telemetry *telemetry = (Telemetry *)arg;
+    double lastMetrics = 0.0;
+
+    while (atomic_load_explicit(&telemetry->running, memory_order_acquire)) {
+        int count = TelemetryDrain(telemetry);
+
+        double now = GetMonotonicTime();
+        if (now - lastMetrics >= 1.0) {
+            TelemetryWriteMetrics(telemetry);
+            lastMetrics = now;
+        }
+
+        if (count == 0) {
+            if (telemetry->log) fflush(telemetry->log);
+#ifdef _WIN32
+            Sleep(5);
+#else
+            struct timespec pause = { 0, 5 * 1000 * 1000 }; // 5 ms
+            nanosleep(&pause, NULL);
+#endif
+        }
+    }
+
+    // Grava o que sobrou antes de encerrar
+    TelemetryDrain(telemetry);
+    TelemetryWriteMetrics(telemetry);
+    if (telemetry->log) fflush(telemetry->log);
+    return NULL;
+}
+
+bool TelemetryStart(Telemetry *telemetry, const char *logPath, bool binary, const char *metricsPath) {
+    memset(telemetry, 0, sizeof(Telemetry));
+    atomic_init(&telemetry->head, 0);
+    atomic_init(&telemetry->tail, 0);
+    atomic_init(&telemetry->dropped, 0);
+    atomic_init(&telemetry->running, true);
+
+    telemetry->binary = binary;
+    telemetry->start_time = GetMonotonicTime();
+    if (metricsPath) {
+        snprintf(telemetry->metrics_path, sizeof(telemetry->metrics_path), "%s", metricsPath);
+    }
+
+    if (logPath) {
+        telemetry->log = fopen(logPath, binary ? "wb" : "w");
+        if (!telemetry->log) return false;
+
+        if (binary) {
+            // Cabealho: assinatura, verso e tamanho de cada registro
+            unsigned int header[3] = { 0x4C544D42u, 1, (unsigned int)sizeof(TelemetryEvent) }; // "BMTL"
+            fwrite(header, sizeof(header), 1, telemetry->log);
+        }
+    }
+
+    if (pthread_create(&telemetry->thread, NULL, TelemetryWriterMain, telemetry) != 0) {
+        if (telemetry->log) fclose(telemetry->log);
+        telemetry->log = NULL;
+        return false;
+    }
+    return true;
+}
+
+void TelemetryStop(Telemetry *telemetry) {
+    if (!atomic_load(&telemetry->running)) return;
+
+    atomic_store_explicit(&telemetry->running, false, memory_order_release);
+    pthread_join(telemetry->thread, NULL);
+
+    if (telemetry->log) {
+        fclose(telemetry->log);
+        telemetry->log = NULL;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Pool de threads genrico
+// ---------------------------------------------------------------------------
+
+static void WorkerPoolRunChunks(WorkerPool *pool) {
+    for (;;) {
+        int begin = atomic_fetch_add_explicit(&pool->next, pool->chunk, memory_order_relaxed);
+        if (begin >= pool->count) break;
+        int end = begin + pool->chunk < pool->count ? begin + pool->chunk : pool->count;
+        pool->fn(pool->context, begin, end);
+    }
+}
+
+static void *WorkerPoolMain(void *arg) {
+    WorkerPool *pool = (WorkerPool *)arg;
+    int seen = 0;
+
+    for (;;) {
+        pthread_mutex_lock(&pool->lock);
+        while (pool->generation == seen && !pool->quit) {
+            pthread_cond_wait(&pool->start, &pool->lock);
+        }
+        seen = pool->generation;
+        bool quit = pool->quit;
+        pthread_mutex_unlock(&pool->lock);
+        if (quit) break;
+
+        WorkerPoolRunChunks(pool);
+
+        pthread_mutex_lock(&pool->lock);
+        if (--pool->pending == 0) {
+            pthread_cond_signal(&pool->done);
+        }
+        pthread_mutex_unlock(&pool->lock);
+    }
+    return NULL;
+}
+
+// Nmero de threads pedido, ou um por ncleo se threads <= 0, at maxThreads
+int ResolveThreadCount(int threads, int maxThreads) {
+    if (threads <= 0) {
+#ifdef _WIN32
+        long cores = (long)GetActiveProcessorCount(0xFFFF); // ALL_PROCESSOR_GROUPS
+#else
+        long cores = sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+        threads = cores > 0 ? (int)cores : 1;
+    }
+    return threads > maxThreads ? maxThreads : threads;
+}
+
+// threads <= 0 usa um por ncleo, contando a thread que chama WorkerPoolFor
+void WorkerPoolInit(WorkerPool *pool, int threads) {
+    memset(pool, 0, sizeof(WorkerPool));
+    threads = ResolveThreadCount(threads, POOL_MAX_THREADS);
+
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->start, NULL);
+    pthread_cond_init(&pool->done, NULL);
+    atomic_init(&pool->next, 0);
+
+    for (int i = 1; i < threads; i++) {
+        if (pthread_create(&pool->threads[pool->thread_count], NULL, WorkerPoolMain, pool) != 0) break;
+        pool->thread_count++;
+    }
+}
+
+void WorkerPoolShutdown(WorkerPool *pool) {
+    pthread_mutex_lock(&pool->lock);
+    pool->quit = true;
+    pthread_cond_broadcast(&pool->start);
+    pthread_mutex_unlock(&pool->lock);
+
+    for (int i = 0; i < pool->thread_count; i++) {
+        pthread_join(pool->threads[i], NULL);
+    }
+    pool->thread_count = 0;
+
+    pthread_mutex_destroy(&pool->lock);
+    pthread_cond_destroy(&pool->start);
+    pthread_cond_destroy(&pool->done);
+}
+
+// Chama fn(context, begin, end) para blocos de at chunk ndices cobrindo
+// [0, count) e s retorna quando todos terminarem. pool pode ser NULL.
+void WorkerPoolFor(WorkerPool *pool, int count, int chunk, ParallelFn fn, void *context) {
+    if (count <= 0) return;
+    if (chunk < 1) chunk = 1;
+
+    if (!pool || pool->thread_count == 0 || count <= chunk) {
+        fn(context, 0, count);
+        return;
+    }
+
+    pthread_mutex_lock(&pool->lock);
+    pool->fn = fn;
+    pool->context = context;
+    pool->count = count;
+    pool->chunk = chunk;
+    atomic_store_explicit(&pool->next, 0, memory_order_relaxed);
+    pool->pending = pool->thread_count;
+    pool->generation++;
+    pthread_cond_broadcast(&pool->start);
+    pthread_mutex_unlock(&pool->lock);
+
+    WorkerPoolRunChunks(pool);
+
+    pthread_mutex_lock(&pool->lock);
+    while (pool->pending > 0) {
+        pthread_cond_wait(&pool->done, &pool->lock);
+    }
+    pthread_mutex_unlock(&pool->lock);
+}
+
+// ---------------------------------------------------------------------------
+// Ambiente vetorizado para RL
+//
+// Observaes: para cada ambiente, OBS_PLANES planos GRID_SIZE x GRID_SIZE
+// (ordem de ObsPlane, linha por linha), contguos no buffer do chamador:
+// float em [0, 1] ou uint8 em [0, 255].
+// Recompensa por ao: +1 por inimigo morto, +0.1 por power-up, +2 ao
+// completar a fase e -1 ao morrer. O episdio acaba ao morrer, ao completar
+// a fase ou aps max_steps aes.
+// ---------------------------------------------------------------------------
+
+static void VecEnvResetOne(VecEnv *env, int i) {
+    GameState *game = &env->games[i];
+    unsigned int rng = game->rng;
+
+    ResetGame(game);
+    game->rng = rng ? rng : 1;
+    ConfigurePlayers(game, 0, 1 + env->bots, BOT_HEURISTIC);
+    InitGame(game, env->level);
+    env->steps[i] = 0;
+    env->returns[i] = 0.0f;
+}
+
+static inline void ObsPut(float *f32, unsigned char *u8, int index, float value) {
+    if (f32) f32[index] = value;
+    if (u8) u8[index] = (unsigned char)(value * 255.0f + 0.5f);
+}
+
+static void VecEnvObserveOne(const VecEnv *env, int i, float *obsF32, unsigned char *obsU8) {
+    const GameState *game = &env->games[i];
+    const int cells = GRID_SIZE * GRID_SIZE;
+    float *f32 = obsF32 ? obsF32 + (size_t)i * OBS_SIZE : NULL;
+    unsigned char *u8 = obsU8 ? obsU8 + (size_t)i * OBS_SIZE : NULL;
+
+    if (f32) memset(f32, 0, sizeof(float) * OBS_SIZE);
+    if (u8) memset(u8, 0, OBS_SIZE);
+
+    for (int y = 0; y < GRID_SIZE; y++) {
+        for (int x = 0; x < GRID_SIZE; x++) {
+            int cell = y * GRID_SIZE + x;
+            switch (game->grid[y][x]) {
+                case INDESTRUCTIBLE: ObsPut(f32, u8, OBS_INDESTRUCTIBLE * cells + cell, 1.0f); break;
+                case DESTRUCTIBLE: ObsPut(f32, u8, OBS_DESTRUCTIBLE * cells + cell, 1.0f); break;
+                case EXIT: ObsPut(f32, u8, OBS_EXIT * cells + cell, 1.0f); break;
+                case BOMB_POWERUP: ObsPut(f32, u8, OBS_BOMB_POWERUP * cells + cell, 1.0f); break;
+                case RANGE_POWERUP: ObsPut(f32, u8, OBS_RANGE_POWERUP * cells + cell, 1.0f); break;
+                default: break;
+            }
+        }
+    }
+
+    for (int p = 0; p < game->player_count; p++) {
+        const Player *player = &game->players[p];
+        if (!player->alive) continue;
+        int plane = (p == 0) ? OBS_SELF : OBS_OTHER_PLAYERS;
+        ObsPut(f32, u8, plane * cells + player->y * GRID_SIZE + player->x, 1.0f);
+    }
+    for (int e = 0; e < game->enemy_count; e++) {
+        const Enemy *enemy = &game->enemies[e];
+        if (enemy->alive) {
+            ObsPut(f32, u8, OBS_ENEMIES * cells + enemy->y * GRID_SIZE + enemy->x, 1.0f);
+        }
+    }
+    for (int b = 0; b < game->bomb_count; b++) {
+        const Bomb *bomb = &game->bombs[b];
+        if (bomb->exploded) continue;
+        float fuse = (float)bomb->timer / game->difficulty.bomb_fuse;
+        if (fuse > 1.0f) fuse = 1.0f;
+        if (fuse < 0.0f) fuse = 0.0f;
+        ObsPut(f32, u8, OBS_BOMBS * cells + bomb->y * GRID_SIZE + bomb->x, fuse);
+    }
+    for (int f = 0; f < game->explosion_count; f++) {
+        const Explosion *fire = &game->explosions[f];
+        ObsPut(f32, u8, OBS_FIRE * cells + fire->y * GRID_SIZE + fire->x, 1.0f);
+    }
+}
+
+static void VecEnvStepRange(void *context, int begin, int end) {
+    VecEnv *env = (VecEnv *)context;
+
+    for (int i = begin; i < end; i++) {
+        GameState *game = &env->games[i];
+        Player *agent = &game->players[0];
+
+        if (env->actions) {
+            int action = env->actions[i];
+            if (action < 0 || action >= NUM_ACTIONS) action = ACTION_STAY;
+
+            int score = agent->score;
+            int powerups = agent->max_bombs + agent->bomb_range;
+            SimulateDecision(game, 0, action);
+
+            // Cada inimigo vale 100 pontos
+            float reward = (agent->score - score) / 100.0f;
+            reward += 0.1f * ((agent->max_bombs + agent->bomb_range) - powerups);
+
+            bool done = false;
+            if (!agent->alive) {
+                reward -= 1.0f;
+                done = true;
+            }
+            else if (game->level_complete) {
+                reward += 2.0f;
+                env->wins[i]++;
+                done = true;
+            }
+            else if (++env->steps[i] >= env->max_steps) {
+                done = true;
+            }
+
+            env->returns[i] += reward;
+            if (env->rewards) env->rewards[i] = reward;
+            if (env->dones) env->dones[i] = done;
+
+            if (done) {
+                env->episodes[i]++;
+                env->return_sum[i] += env->returns[i];
+                VecEnvResetOne(env, i);
+            }
+        }
+
+        if (env->obs_f32 || env->obs_u8) {
+            VecEnvObserveOne(env, i, env->obs_f32, env->obs_u8);
+        }
+    }
+}
+
+static void VecEnvResetRange(void *context, int begin, int end) {
+    VecEnv *env = (VecEnv *)context;
+
+    for (int i = begin; i < end; i++) {
+        VecEnvResetOne(env, i);
+        if (env->obs_f32 || env->obs_u8) {
+            VecEnvObserveOne(env, i, env->obs_f32, env->obs_u8);
+        }
+    }
+}
+
+VecEnv *VecEnvCreate(int count, unsigned int seed, WorkerPool *pool) {
+    VecEnv *env = calloc(1, sizeof(VecEnv));
+    if (!env) return NULL;
+
+    env->count = count;
+    env->level = 1;
+    env->max_steps = ENV_MAX_STEPS;
+    env->pool = pool;
+    env->games = calloc(count, sizeof(GameState));
+    env->steps = calloc(count, sizeof(int));
+    env->returns = calloc(count, sizeof(float));
+    env->episodes = calloc(count, sizeof(int));
+    env->wins = calloc(count, sizeof(int));
+    env->return_sum = calloc(count, sizeof(double));
+
+    if (!env->games || !env->steps || !env->returns || !env->episodes || !env->wins || !env->return_sum) {
+        VecEnvDestroy(env);
+        return NULL;
+    }
+
+    // Cada ambiente tem sua prpria sequncia aleatria
+    for (int i = 0; i < count; i++) {
+        unsigned int rng = ((seed + 1u) * 2654435761u) ^ ((unsigned int)(i + 1) * 0x9E3779B9u);
+        env->games[i].rng = rng ? rng : 1;
+    }
+    return env;
+}
+
+void VecEnvDestroy(VecEnv *env) {
+    if (!env) return;
+    free(env->games);
+    free(env->steps);
+    free(env->returns);
+    free(env->episodes);
+    free(env->wins);
+    free(env->return_sum);
+    free(env);
+}
+
+// Gera um mapa novo em todos os ambientes e escreve as observaes
+void VecEnvReset(VecEnv *env, float *obsF32, unsigned char *obsU8) {
+    env->obs_f32 = obsF32;
+    env->obs_u8 = obsU8;
+    WorkerPoolFor(env->pool, env->count, 16, VecEnvResetRange, env);
+}
+
+// Aplica uma ao por ambiente. rewards, dones e os buffers de observao
+// (count * OBS_SIZE valores) pertencem ao chamador; qualquer um pode ser
+// NULL. Onde done = 1 a observao escrita j  a do episdio seguinte.
+void VecEnvStep(VecEnv *env, const int *actions, float *rewards, unsigned char *dones, float *obsF32, unsigned char *obsU8) {
+    env->actions = actions;
+    env->rewards = rewards;
+    env->dones = dones;
+    env->obs_f32 = obsF32;
+    env->obs_u8 = obsU8;
+    WorkerPoolFor(env->pool, env->count, 16, VecEnvStepRange, env);
+    env->actions = NULL;
+}
+
+void VecEnvObserve(VecEnv *env, float *obsF32, unsigned char *obsU8) {
+    VecEnvStep(env, NULL, NULL, NULL, obsF32, obsU8);
+}
+
+// ---------------------------------------------------------------------------
+// Benchmark do ambiente vetorizado (./bomberman --bench-env [threads])
+// ---------------------------------------------------------------------------
+
+static void RunEnvBenchmarkCase(WorkerPool *pool, int count, bool asFloat) {
+    VecEnv *env = VecEnvCreate(count, 7, pool);
+    int *actions = malloc(sizeof(int) * count);
+    float *rewards = malloc(sizeof(float) * count);
+    unsigned char *dones = malloc(count);
+    float *obsF32 = asFloat ? malloc(sizeof(float) * (size_t)count * OBS_SIZE) : NULL;
+    unsigned char *obsU8 = asFloat ? NULL : malloc((size_t)count * OBS_SIZE);
+
+    if (!env || !actions || !rewards || !dones || (!obsF32 && !obsU8)) {
+        printf("  %5d ambientes: sem memria\n", count);
+    }
+    else {
+        VecEnvReset(env, obsF32, obsU8);
+
+        unsigned int rng = 12345;
+        long long steps = 0;
+        double start = GetMonotonicTime();
+        double elapsed = 0.0;
+        while (elapsed < 1.0) {
+            for (int i = 0; i < count; i++) {
+                actions[i] = MctsRandom(&rng) % NUM_ACTIONS;
+            }
+            VecEnvStep(env, actions, rewards, dones, obsF32, obsU8);
+            steps += count;
+            elapsed = GetMonotonicTime() - start;
+        }
+
+        long long episodes = 0;
+        for (int i = 0; i < count; i++) {
+            episodes += env->episodes[i];
+        }
+
+        printf("  %5d ambientes, obs %s: %10.0f passos/s (%.0f frames/s), %lld episdios\n",
+               count, asFloat ? "float" : "uint8", steps / elapsed,
+               steps * (double)BOT_THINK_TICKS / elapsed, episodes);
+    }
+
+    VecEnvDestroy(env);
+    free(actions);
+    free(rewards);
+    free(dones);
+    free(obsF32);
+    free(obsU8);
+}
+
+void RunEnvBenchmark(int threads) {
+    static WorkerPool pool;
+    WorkerPoolInit(&pool, threads);
+
+    printf("Ambiente vetorizado: %d threads, %d valores de observao por ambiente, aes aleatrias\n",
+           pool.thread_count + 1, OBS_SIZE);
+
+    int counts[] = { 1, 64, 4096 };
+    for (int c = 0; c < 3; c++) {
+        RunEnvBenchmarkCase(&pool, counts[c], true);
+        RunEnvBenchmarkCase(&pool, counts[c], false);
+    }
+
+    WorkerPoolShutdown(&pool);
+}
+
+// ---------------------------------------------------------------------------
+// Backend de renderizao por CPU
+//
+// Compe os sprites (RGBA8) num framebuffer em memria com alfa "over".
+// O framebuffer  sempre opaco. Com SSE2 (padro em x86-64) a mistura 
+// feita 4 pixels por vez; o resultado  idntico ao da verso escalar.
+// ---------------------------------------------------------------------------
+
+// Fonte 3x5 para o HUD, caracteres 32 a 95 (minsculas viram maisculas).
+// Cada dgito octal  uma linha, de cima para baixo; o bit 4  a coluna
+// da esquerda.
+static const unsigned short CPU_FONT[64] = {
+    000000, 022202, 055000, 057575, 036236, 051245, 025253, 022000, // (espao) ! " # $ % & '
+    012221, 042224, 005250, 002720, 000024, 000700, 000002, 011244, // ( ) * + , - . /
+    075557, 026227, 071747, 071317, 055711, 074717, 074757, 071111, // 0-7
+    075757, 075717, 002020, 002024, 012421, 007070, 042124, 071302, // 8 9 : ; < = > ?
+    075747, 025755, 065656, 034443, 065556, 074647, 074644, 034553, // @ A-G
+    055755, 072227, 011152, 055655, 044447, 057755, 065555, 025552, // H-O
+    065644, 025563, 065655, 034216, 072222, 055557, 055552, 055775, // P-W
+    055255, 055222, 071247, 064446, 044211, 031113, 025000, 000007  // X Y Z [ \ ] ^ _
+};
+
+// Cor dos sprites gerados quando o arquivo da textura no existe
+static const Color CPU_FALLBACK_COLORS[NUM_TEXTURES] = {
+    { 200, 200, 200, 255 },     // Vazio
+    { 80, 80, 80, 255 },        // Indestrutvel
+    { 160, 110, 60, 255 },      // Destrutvel
+    { 0, 200, 80, 255 },        // Sada
+    { 230, 60, 60, 255 },       // Power-up de bomba
+    { 240, 170, 0, 255 },       // Power-up de alcance
+    { 255, 255, 255, 255 },     // Jogador (recebe a cor de cada um)
+    { 200, 0, 200, 255 },       // Inimigo
+    { 20, 20, 20, 255 },        // Bomba
+    { 255, 120, 0, 200 }        // Exploso
+};
+
+static void CpuMakeSprite(CpuSprite *sprite, TextureType texture) {
+    sprite->width = TILE_SIZE;
+    sprite->height = TILE_SIZE;
+    sprite->pixels = malloc((size_t)TILE_SIZE * TILE_SIZE * 4);
+    if (!sprite->pixels) return;
+
+    // Cho e paredes ocupam o tile todo; o resto vira um crculo
+    bool round = texture >= TEX_PLAYER;
+    Color color = CPU_FALLBACK_COLORS[texture];
+    float radius = TILE_SIZE * 0.42f;
+    for (int y = 0; y < TILE_SIZE; y++) {
+        for (int x = 0; x < TILE_SIZE; x++) {
+            float dx = x + 0.5f - TILE_SIZE / 2.0f;
+            float dy = y + 0.5f - TILE_SIZE / 2.0f;
+            bool inside = !round || dx * dx + dy * dy <= radius * radius;
+            unsigned char *p = sprite->pixels + (y * TILE_SIZE + x) * 4;
+            p[0] = color.r;
+            p[1] = color.g;
+            p[2] = color.b;
+            p[3] = inside ? color.a : 0;
+        }
+    }
+}
+
+// Carrega as texturas como imagens (no precisa de janela nem de GPU)
+void CpuLoadSprites(CpuSprite *sprites) {
+    for (int i = 0; i < NUM_TEXTURES; i++) {
+        CpuSprite *sprite = &sprites[i];
+        memset(sprite, 0, sizeof(CpuSprite));
+
+        Image image = LoadImage(TEXTURE_FILES[i]);
+        if (image.data) {
+            ImageFormat(&image, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+            if (image.width != TILE_SIZE || image.height != TILE_SIZE) {
+                ImageResize(&image, TILE_SIZE, TILE_SIZE);
+            }
+            size_t bytes = (size_t)image.width * image.height * 4;
+            sprite->pixels = malloc(bytes);
+            if (sprite->pixels) {
+                memcpy(sprite->pixels, image.data, bytes);
+                sprite->width = image.width;
+                sprite->height = image.height;
+            }
+            UnloadImage(image);
+        }
+        if (!sprite->pixels) {
+            CpuMakeSprite(sprite, (TextureType)i);
+        }
+        if (!sprite->pixels) continue;
+
+        sprite->opaque = true;
+        for (int p = 0; p < sprite->width * sprite->height; p++) {
+            if (sprite->pixels[p * 4 + 3] != 255) {
+                sprite->opaque = false;
+                break;
+            }
+        }
+    }
+}
+
+void CpuUnloadSprites(CpuSprite *sprites) {
+    for (int i = 0; i < NUM_TEXTURES; i++) {
+        free(sprites[i].pixels);
+        sprites[i].pixels = NULL;
+    }
+}
+
+void CpuClear(CpuTarget *target, Color color) {
+    unsigned int value;
+    unsigned char bytes[4] = { color.r, color.g, color.b, 255 };
+    memcpy(&value, bytes, 4);
+
+    unsigned int *pixels = (unsigned int *)target->pixels;
+    int count = target->width * target->height;
+    for (int i = 0; i < count; i++) {
+        pixels[i] = value;
+    }
+}
+
+// Mistura count pixels de src sobre dst: dst = (src*a + dst*(255-a)) / 255
+static void CpuBlendRow(unsigned char *dst, const unsigned char *src, int count) {
+    int i = 0;
+
+#ifdef __SSE2__
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i full = _mm_set1_epi16(255);
+    const __m128i half = _mm_set1_epi16(128);
+    const __m128i opaque = _mm_set1_epi32((int)0xFF000000);
+
+    for (; i + 4 <= count; i += 4) {
+        __m128i s = _mm_loadu_si128((const __m128i *)(src + i * 4));
+        __m128i d = _mm_loadu_si128((const __m128i *)(dst + i * 4));
+
+        __m128i sLo = _mm_unpacklo_epi8(s, zero);
+        __m128i sHi = _mm_unpackhi_epi8(s, zero);
+        __m128i dLo = _mm_unpacklo_epi8(d, zero);
+        __m128i dHi = _mm_unpackhi_epi8(d, zero);
+
+        // Alfa de cada pixel repetido nos 4 canais
+        __m128i aLo = _mm_shufflehi_epi16(_mm_shufflelo_epi16(sLo, 0xFF), 0xFF);
+        __m128i aHi = _mm_shufflehi_epi16(_mm_shufflelo_epi16(sHi, 0xFF), 0xFF);
+
+        __m128i lo = _mm_add_epi16(_mm_mullo_epi16(sLo, aLo), _mm_mullo_epi16(dLo, _mm_sub_epi16(full, aLo)));
+        __m128i hi = _mm_add_epi16(_mm_mullo_epi16(sHi, aHi), _mm_mullo_epi16(dHi, _mm_sub_epi16(full, aHi)));
+        lo = _mm_add_epi16(lo, half);
+        hi = _mm_add_epi16(hi, half);
+        lo = _mm_srli_epi16(_mm_add_epi16(lo, _mm_srli_epi16(lo, 8)), 8);
+        hi = _mm_srli_epi16(_mm_add_epi16(hi, _mm_srli_epi16(hi, 8)), 8);
+
+        __m128i out = _mm_or_si128(_mm_packus_epi16(lo, hi), opaque);
+        _mm_storeu_si128((__m128i *)(dst + i * 4), out);
+    }
+#endif
+
+    for (; i < count; i++) {
+        const unsigned char *s = src + i * 4;
+        unsigned char *d = dst + i * 4;
+        unsigned int a = s[3];
+        for (int c = 0; c < 3; c++) {
+            unsigned int v = s[c] * a + d[c] * (255 - a) + 128;
+            d[c] = (unsigned char)((v + (v >> 8)) >> 8);
+        }
+        d[3] = 255;
+    }
+}
+
+static void CpuSpriteDraw(void *data, TextureType texture, Vector2 position, Color tint) {
+    CpuTarget *target = (CpuTarget *)data;
+    const CpuSprite *sprite = &target->sprites[texture];
+    if (!sprite->pixels) return;
+
+    int left = (int)floorf(position.x + 0.5f);
+    int top = (int)floorf(position.y + 0.5f);
+
+    // Recorte nas bordas do framebuffer
+    int x0 = left < 0 ? -left : 0;
+    int y0 = top < 0 ? -top : 0;
+    int x1 = left + sprite->width > target->width ? target->width - left : sprite->width;
+    int y1 = top + sprite->height > target->height ? target->height - top : sprite->height;
+    if (x0 >= x1 || y0 >= y1) return;
+
+    bool tinted = tint.r != 255 || tint.g != 255 || tint.b != 255 || tint.a != 255;
+    unsigned char row[TILE_SIZE * 4];
+    int width = x1 - x0;
+
+    for (int y = y0; y < y1; y++) {
+        const unsigned char *src = sprite->pixels + ((size_t)y * sprite->width + x0) * 4;
+        unsigned char *dst = target->pixels + ((size_t)(top + y) * target->width + left + x0) * 4;
+
+        if (tinted && width <= TILE_SIZE) {
+            // Multiplica pela cor, como o DrawTextureV da raylib
+            for (int x = 0; x < width * 4; x += 4) {
+                row[x + 0] = (unsigned char)(src[x + 0] * tint.r / 255);
+                row[x + 1] = (unsigned char)(src[x + 1] * tint.g / 255);
+                row[x + 2] = (unsigned char)(src[x + 2] * tint.b / 255);
+                row[x + 3] = (unsigned char)(src[x + 3] * tint.a / 255);
+            }
+            CpuBlendRow(dst, row, width);
+        }
+        else if (sprite->opaque) {
+            memcpy(dst, src, (size_t)width * 4);
+        }
+        else {
+            CpuBlendRow(dst, src, width);
+        }
+    }
+}
+
+static void CpuRectDraw(void *data, int x, int y, int width, int height, Color color) {
+    CpuTarget *target = (CpuTarget *)data;
+
+    if (x < 0) { width += x; x = 0; }
+    if (y < 0) { height += y; y = 0; }
+    if (x + width > target->width) width = target->width - x;
+    if (y + height > target->height) height = target->height - y;
+    if (width <= 0 || height <= 0 || color.a == 0) return;
+
+    // Linha de cor slida misturada em blocos de 64 pixels
+    unsigned char row[64 * 4];
+    for (int i = 0; i < 64; i++) {
+        row[i * 4 + 0] = color.r;
+        row[i * 4 + 1] = color.g;
+        row[i * 4 + 2] = color.b;
+        row[i * 4 + 3] = color.a;
+    }
+
+    for (int py = y; py < y + height; py++) {
+        unsigned char *dst = target->pixels + ((size_t)py * target->width + x) * 4;
+        for (int done = 0; done < width; done += 64) {
+            int count = width - done < 64 ? width - done : 64;
+            if (color.a == 255) {
+                memcpy(dst + done * 4, row, (size_t)count * 4);
+            }
+            else {
+                CpuBlendRow(dst + done * 4, row, count);
+            }
+        }
+    }
+}
+
+static void CpuTextDraw(void *data, const char *text, int x, int y, int size, Color color) {
+    int scale = (size + 4) / 8;
+    if (scale < 1) scale = 1;
+
+    for (int cx = x; *text; text++, cx += 4 * scale) {
+        int c = (unsigned char)*text;
+        if (c >= 'a' && c <= 'z') c -= 'a' - 'A';
+        if (c < 32 || c > 95) c = '?';
+        unsigned short glyph = CPU_FONT[c - 32];
+
+        for (int row = 0; row < 5; row++) {
+            int bits = (glyph >> ((4 - row) * 3)) & 7;
+            for (int col = 0; col < 3; col++) {
+                if (bits & (4 >> col)) {
+                    CpuRectDraw(data, cx + col * scale, y + row * scale, scale, scale, color);
+                }
+            }
+        }
+    }
+}
+
+Renderer CpuRenderer(CpuTarget *target) {
+    Renderer renderer = { target, CpuSpriteDraw, CpuRectDraw, CpuTextDraw };
+    return renderer;
+}
+
+// ---------------------------------------------------------------------------
+// Gravao de frames em threads
+// ---------------------------------------------------------------------------
+
+#define FRAME_FREE 0
+#define FRAME_QUEUED 1
+#define FRAME_WORKING 2
+
+static void *FrameEncoderMain(void *arg) {
+    FrameEncoder *encoder = (FrameEncoder *)arg;
+    CpuTarget target = { encoder->sprites, NULL, SCREEN_WIDTH, SCREEN_HEIGHT };
+    target.pixels = malloc((size_t)SCREEN_WIDTH * SCREEN_HEIGHT * 4);
+    Renderer renderer = CpuRenderer(&target);
+
+    for (;;) {
+        // Pega o frame enfileirado mais antigo
+        pthread_mutex_lock(&encoder->lock);
+        FrameJob *job = NULL;
+        for (;;) {
+            for (int i = 0; i < FRAME_QUEUE_SIZE; i++) {
+                FrameJob *candidate = &encoder->jobs[i];
+                if (candidate->status == FRAME_QUEUED && (!job || candidate->index < job->index)) {
+                    job = candidate;
+                }
+            }
+            if (job || encoder->quit) break;
+            pthread_cond_wait(&encoder->work, &encoder->lock);
+        }
+        if (!job) {
+            pthread_mutex_unlock(&encoder->lock);
+            break;
+        }
+        job->status = FRAME_WORKING;
+        pthread_mutex_unlock(&encoder->lock);
+
+        double start = GetMonotonicTime();
+        bool ok = target.pixels != NULL;
+        if (ok) {
+            CpuClear(&target, RAYWHITE);
+            DrawGame(&renderer, &job->state);
+            DrawHud(&renderer, &job->state);
+        }
+        double rendered = GetMonotonicTime();
+
+        if (encoder->raw) {
+            // O vdeo bruto precisa dos frames em ordem
+            pthread_mutex_lock(&encoder->lock);
+            while (encoder->next_write != job->index) {
+                pthread_cond_wait(&encoder->written, &encoder->lock);
+            }
+            pthread_mutex_unlock(&encoder->lock);
+
+            size_t bytes = (size_t)SCREEN_WIDTH * SCREEN_HEIGHT * 4;
+            ok = ok && fwrite(target.pixels, 1, bytes, encoder->raw) == bytes;
+
+            pthread_mutex_lock(&encoder->lock);
+            encoder->next_write++;
+            pthread_cond_broadcast(&encoder->written);
+            pthread_mutex_unlock(&encoder->lock);
+        }
+        else if (encoder->png_prefix[0] && ok) {
+            char path[300];
+            Image image = { target.pixels, SCREEN_WIDTH, SCREEN_HEIGHT, 1, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8 };
+            snprintf(path, sizeof(path), "%s_%05lld.png", encoder->png_prefix, job->index);
+            ok = ExportImage(image, path);
+        }
+        double encoded = GetMonotonicTime();
+
+        pthread_mutex_lock(&encoder->lock);
+        job->status = FRAME_FREE;
+        encoder->frames++;
+        encoder->render_seconds += rendered - start;
+        encoder->encode_seconds += encoded - rendered;
+        if (!ok) encoder->failed = true;
+        pthread_cond_signal(&encoder->space);
+        pthread_mutex_unlock(&encoder->lock);
+    }
+
+    free(target.pixels);
+    return NULL;
+}
+
+// output: "arquivo.png" grava arquivo_00000.png, arquivo_00001.png...;
+// "none" s desenha; qualquer outro nome recebe o vdeo bruto RGBA
+// (SCREEN_WIDTH x SCREEN_HEIGHT, 60 FPS). threads <= 0 usa um por ncleo.
+bool FrameEncoderStart(FrameEncoder *encoder, const char *output, int threads) {
+    memset(encoder, 0, sizeof(FrameEncoder));
+
+    size_t length = strlen(output);
+    if (length > 4 && strcmp(output + length - 4, ".png") == 0) {
+        if (length - 4 >= sizeof(encoder->png_prefix)) return false;
+        memcpy(encoder->png_prefix, output, length - 4);
+    }
+    else if (strcmp(output, "none") != 0) {
+        encoder->raw = fopen(output, "wb");
+        if (!encoder->raw) return false;
+    }
+
+    threads = ResolveThreadCount(threads, FRAME_MAX_THREADS);
+
+    CpuLoadSprites(encoder->sprites);
+    pthread_mutex_init(&encoder->lock, NULL);
+    pthread_cond_init(&encoder->work, NULL);
+    pthread_cond_init(&encoder->space, NULL);
+    pthread_cond_init(&encoder->written, NULL);
+
+    for (int i = 0; i < threads; i++) {
+        if (pthread_create(&encoder->threads[encoder->thread_count], NULL, FrameEncoderMain, encoder) != 0) break;
+        encoder->thread_count++;
+    }
+    if (encoder->thread_count == 0) {
+        FrameEncoderStop(encoder);
+        return false;
+    }
+    return true;
+}
+
+// Copia o estado para a fila; espera se todas as posies estiverem ocupadas
+void FrameEncoderSubmit(FrameEncoder *encoder, const GameState *game) {
+    pthread_mutex_lock(&encoder->lock);
+    FrameJob *job = &encoder->jobs[encoder->submitted % FRAME_QUEUE_SIZE];
+    while (job->status != FRAME_FREE) {
+        pthread_cond_wait(&encoder->space, &encoder->lock);
+    }
+    memcpy(&job->state, game, sizeof(GameState));
+    job->state.telemetry = NULL;
+    job->index = encoder->submitted++;
+    job->status = FRAME_QUEUED;
+    pthread_cond_signal(&encoder->work);
+    pthread_mutex_unlock(&encoder->lock);
+}
+
+// Termina os frames pendentes e libera tudo
+void FrameEncoderStop(FrameEncoder *encoder) {
+    pthread_mutex_lock(&encoder->lock);
+    encoder->quit = true;
+    pthread_cond_broadcast(&encoder->work);
+    pthread_mutex_unlock(&encoder->lock);
+
+    for (int i = 0; i < encoder->thread_count; i++) {
+        pthread_join(encoder->threads[i], NULL);
+    }
+    encoder->thread_count = 0;
+
+    if (encoder->raw) {
+        if (fclose(encoder->raw) != 0) encoder->failed = true;
+        encoder->raw = NULL;
+    }
+    CpuUnloadSprites(encoder->sprites);
+    pthread_mutex_destroy(&encoder->lock);
+    pthread_cond_destroy(&encoder->work);
+    pthread_cond_destroy(&encoder->space);
+    pthread_cond_destroy(&encoder->written);
+}
+
+// ---------------------------------------------------------------------------
+// Renderizao de uma partida entre bots sem janela
+// (./bomberman --render <saida> [jogadores] [ticks] [threads])
+// ---------------------------------------------------------------------------
+
+void RunReplayRender(const char *output, int players, int maxTicks, int threads) {
+    static GameState game;
+    static FrameEncoder encoder;
+
+    if (players < 1) players = 1;
+    if (players > MAX_PLAYERS) players = MAX_PLAYERS;
+
+    if (!FrameEncoderStart(&encoder, output, threads)) {
+        printf("Nao foi possivel abrir a saida: %s\n", output);
+        return;
+    }
+    int encoderThreads = encoder.thread_count;
+
+    // Semente fixa: a mesma linha de comando sempre gera o mesmo vdeo
+    memset(&game, 0, sizeof(GameState));
+    game.rng = 2024;
+    ConfigurePlayers(&game, 0, players, BOT_HEURISTIC);
+    InitGame(&game, 1);
+
+    double start = GetMonotonicTime();
+    double simSeconds = 0.0;
+    int tick = 0;
+
+    FrameEncoderSubmit(&encoder, &game);
+    while (tick < maxTicks && !game.game_over) {
+        double simStart = GetMonotonicTime();
+        UpdateGame(&game, NULL, NULL);
+        tick++;
+
+        if (game.level_complete && game.level < MAX_LEVELS) {
+            InitGame(&game, game.level + 1);
+        }
+        simSeconds += GetMonotonicTime() - simStart;
+
+        FrameEncoderSubmit(&encoder, &game);
+        if (game.level_complete) break;
+    }
+
+    FrameEncoderStop(&encoder);
+    double elapsed = GetMonotonicTime() - start;
+    long long frames = encoder.frames;
+
+    printf("Render por CPU: %lld frames %dx%d, %d threads, saida %s\n",
+           frames, SCREEN_WIDTH, SCREEN_HEIGHT, encoderThreads, output);
+    printf("  desenho:     %.3f ms/frame\n", frames ? encoder.render_seconds * 1000.0 / frames : 0.0);
+    printf("  codificacao: %.3f ms/frame\n", frames ? encoder.encode_seconds * 1000.0 / frames : 0.0);
+    printf("  simulacao:   %.3f ms/frame\n", frames ? simSeconds * 1000.0 / frames : 0.0);
+    printf("  total:       %.2f s, %.0f frames/s, %.1fx o tempo real\n",
+           elapsed, frames / elapsed, frames * SIM_DT / elapsed);
+    if (encoder.failed) {
+        printf("  erro ao gravar alguns frames\n");
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Varredura de parmetros de dificuldade
+// (./bomberman --sweep [sementes] [fase] [threads])
+//
+// Cada combinao de DifficultyConfig da grade abaixo  jogada com as mesmas
+// sementes por um bot simples sozinho, uma fase por partida. As partidas
+// so distribudas entre todos os ncleos pelo WorkerPool.
+// ---------------------------------------------------------------------------
+
+static const int SWEEP_WALLS[] = { 30, 40, 50 };
+static const int SWEEP_ENEMIES[] = { 1, 2, 3 };
+static const int SWEEP_FUSES[] = { 120, 180, 240 };
+static const int SWEEP_FIRE[] = { 30, 60 };
+static const int SWEEP_ENEMY_MOVE[] = { 20, 30, 45 };
+
+#define SWEEP_COUNT(values) ((int)(sizeof(values) / sizeof(values[0])))
+
+typedef enum {
+    SWEEP_CLEARED,
+    SWEEP_KILLED_BY_ENEMY,
+    SWEEP_KILLED_BY_OWN_BOMB,
+    SWEEP_TIMEOUT,
+    NUM_SWEEP_OUTCOMES
+} SweepOutcome;
+
+static const char *SWEEP_OUTCOME_NAMES[NUM_SWEEP_OUTCOMES] = {
+    "cleared", "enemy", "own_bomb", "timeout"
+};
+
+typedef struct {
+    unsigned short ticks;
+    unsigned char outcome;
+} SweepResult;
+
+typedef struct {
+    const DifficultyConfig *configs;
+    int seeds;
+    int level;
+    SweepResult *results;   // configs * seeds, na ordem (config, semente)
+} SweepBatch;
+
+static SweepResult SweepPlayMatch(const DifficultyConfig *config, int level, unsigned int seed) {
+    GameState game;
+    SweepResult result;
+
+    memset(&game, 0, sizeof(GameState));
+    game.difficulty = *config;
+    game.rng = seed ? seed : 1;
+    ConfigurePlayers(&game, 0, 1, BOT_HEURISTIC);
+
+    // A fase 1 d os power-ups iniciais
+    InitGame(&game, 1);
+    if (level > 1) InitGame(&game, level);
+
+    while (game.tick < SWEEP_MAX_TICKS && !game.game_over && !game.level_complete) {
+        UpdateGame(&game, NULL, NULL);
+    }
+
+    const Player *player = &game.players[0];
+    result.ticks = (unsigned short)game.tick;
+    if (game.level_complete) {
+        result.outcome = SWEEP_CLEARED;
+    }
+    else if (player->alive) {
+        result.outcome = SWEEP_TIMEOUT;
+    }
+    else if (player->death_cause == DEATH_ENEMY) {
+        result.outcome = SWEEP_KILLED_BY_ENEMY;
+    }
+    else {
+        result.outcome = SWEEP_KILLED_BY_OWN_BOMB;    // Sozinho, s a prpria bomba explode
+    }
+    return result;
+}
+
+static void SweepRange(void *context, int begin, int end) {
+    SweepBatch *batch = (SweepBatch *)context;
+
+    for (int i = begin; i < end; i++) {
+        const DifficultyConfig *config = &batch->configs[i / batch->seeds];
+        // A mesma semente em todas as configuraes, para compar-las nos mesmos sorteios
+        unsigned int seed = (unsigned int)(i % batch->seeds + 1) * 2654435761u;
+        batch->results[i] = SweepPlayMatch(config, batch->level, seed);
+    }
+}
+
+static int CompareUnsignedShort(const void *a, const void *b) {
+    return (int)*(const unsigned short *)a - (int)*(const unsigned short *)b;
+}
+
+void RunDifficultySweep(int seeds, int level, int threads) {
+    static WorkerPool pool;
+
+    if (seeds < 1) seeds = 1;
+    if (level < 1) level = 1;
+    if (level > MAX_LEVELS) level = MAX_LEVELS;
+
+    int configCount = SWEEP_COUNT(SWEEP_WALLS) * SWEEP_COUNT(SWEEP_ENEMIES) * SWEEP_COUNT(SWEEP_FUSES) *
+                      SWEEP_COUNT(SWEEP_FIRE) * SWEEP_COUNT(SWEEP_ENEMY_MOVE);
+    long long matches = (long long)configCount * seeds;
+    if (matches > 0x7FFFFFFF) {
+        printf("Partidas demais: %lld\n", matches);
+        return;
+    }
+
+    DifficultyConfig *configs = malloc(sizeof(DifficultyConfig) * configCount);
+    SweepResult *results = malloc(sizeof(SweepResult) * (size_t)matches);
+    unsigned short *clearTicks = malloc(sizeof(unsigned short) * seeds);
+    FILE *csv = fopen("sweep.csv", "w");
+    if (!configs || !results || !clearTicks) {
+        printf("Sem memoria para %lld partidas\n", matches);
+        free(configs);
+        free(results);
+        free(clearTicks);
+        if (csv) fclose(csv);
+        return;
+    }
+
+    // Grade completa; o que no varia fica com o valor padro
+    int c = 0;
+    for (int w = 0; w < SWEEP_COUNT(SWEEP_WALLS); w++)
+    for (int e = 0; e < SWEEP_COUNT(SWEEP_ENEMIES); e++)
+    for (int f = 0; f < SWEEP_COUNT(SWEEP_FUSES); f++)
+    for (int t = 0; t < SWEEP_COUNT(SWEEP_FIRE); t++)
+    for (int m = 0; m < SWEEP_COUNT(SWEEP_ENEMY_MOVE); m++) {
+        configs[c] = DEFAULT_DIFFICULTY;
+        configs[c].walls_base = SWEEP_WALLS[w];
+        configs[c].enemies_base = SWEEP_ENEMIES[e];
+        configs[c].bomb_fuse = SWEEP_FUSES[f];
+        configs[c].fire_ticks = SWEEP_FIRE[t];
+        configs[c].enemy_move_ticks = SWEEP_ENEMY_MOVE[m];
+        c++;
+    }
+
+    WorkerPoolInit(&pool, threads);
+    SweepBatch batch = { configs, seeds, level, results };
+
+    double start = GetMonotonicTime();
+    WorkerPoolFor(&pool, (int)matches, 32, SweepRange, &batch);
+    double elapsed = GetMonotonicTime() - start;
+
+    long long totalTicks = 0;
+    for (long long i = 0; i < matches; i++) {
+        totalTicks += results[i].ticks;
+    }
+
+    printf("Varredura: %d configuracoes x %d sementes, fase %d, %d threads\n",
+           configCount, seeds, level, pool.thread_count + 1);
+    printf("  %lld partidas em %.2f s: %.0f partidas/s, %.1f M ticks/s\n\n",
+           matches, elapsed, matches / elapsed, totalTicks / elapsed / 1e6);
+    printf("  paredes inimigos pavio fogo passo | vitoria  media(s) mediana(s) | inimigo bomba_propria tempo\n");
+
+    if (csv) {
+        fprintf(csv, "walls_base,enemies_base,bomb_fuse,fire_ticks,enemy_move_ticks,matches,win_rate,mean_clear_s,median_clear_s");
+        for (int o = SWEEP_KILLED_BY_ENEMY; o < NUM_SWEEP_OUTCOMES; o++) {
+            fprintf(csv, ",%s_rate", SWEEP_OUTCOME_NAMES[o]);
+        }
+        fprintf(csv, "\n");
+    }
+
+    for (c = 0; c < configCount; c++) {
+        const DifficultyConfig *config = &configs[c];
+        const SweepResult *configResults = &results[(size_t)c * seeds];
+        int outcomes[NUM_SWEEP_OUTCOMES] = { 0 };
+        int wins = 0;
+        double clearSum = 0.0;
+
+        for (int s = 0; s < seeds; s++) {
+            outcomes[configResults[s].outcome]++;
+            if (configResults[s].outcome == SWEEP_CLEARED) {
+                clearTicks[wins++] = configResults[s].ticks;
+                clearSum += configResults[s].ticks;
+            }
+        }
+
+        double mean = wins ? clearSum * SIM_DT / wins : 0.0;
+        double median = 0.0;
+        if (wins) {
+            qsort(clearTicks, wins, sizeof(unsigned short), CompareUnsignedShort);
+            median = clearTicks[wins / 2] * SIM_DT;
+        }
+
+        bool isDefault = config->walls_base == DEFAULT_DIFFICULTY.walls_base &&
+                         config->enemies_base == DEFAULT_DIFFICULTY.enemies_base &&
+                         config->bomb_fuse == DEFAULT_DIFFICULTY.bomb_fuse &&
+                         config->fire_ticks == DEFAULT_DIFFICULTY.fire_ticks &&
+                         config->enemy_move_ticks == DEFAULT_DIFFICULTY.enemy_move_ticks;
+        printf("%s %7d %8d %5d %4d %5d | %6.1f%% %8.1f %10.1f | %6.1f%% %12.1f%% %5.1f%%\n",
+               isDefault ? "*" : " ", config->walls_base, config->enemies_base, config->bomb_fuse,
+               config->fire_ticks, config->enemy_move_ticks, 100.0 * wins / seeds, mean, median,
+               100.0 * outcomes[SWEEP_KILLED_BY_ENEMY] / seeds, 100.0 * outcomes[SWEEP_KILLED_BY_OWN_BOMB] / seeds,
+               100.0 * outcomes[SWEEP_TIMEOUT] / seeds);
+
+        if (csv) {
+            fprintf(csv, "%d,%d,%d,%d,%d,%d,%.4f,%.2f,%.2f", config->walls_base, config->enemies_base,
+                    config->bomb_fuse, config->fire_ticks, config->enemy_move_ticks, seeds,
+                    (double)wins / seeds, mean, median);
+            for (int o = SWEEP_KILLED_BY_ENEMY; o < NUM_SWEEP_OUTCOMES; o++) {
+                fprintf(csv, ",%.4f", (double)outcomes[o] / seeds);
+            }
+            fprintf(csv, "\n");
+        }
+    }
+    printf("\n  * = dificuldade padrao%s\n", csv ? ". Tabela completa em sweep.csv" : "");
+
+    if (csv) fclose(csv);
+    WorkerPoolShutdown(&pool);
+    free(configs);
+    free(results);
+    free(clearTicks);
 }